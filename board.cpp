@@ -0,0 +1,33 @@
+/*
+ * File: board.cpp
+ * ---------------
+ * Holds the sets of cubes for the board sizes the game is played at. The
+ * rest of the Board template is in board.h.
+ */
+
+#include "board.h"
+
+
+/* Constants
+ * ---------
+ */
+
+static const char *const StandardCubes[16]  =
+{"AAEEGN", "ABBJOO", "ACHOPS", "AFFKPS", "AOOTTW", "CIMOTU", "DEILRX", "DELRVY",
+	"DISTTY", "EEGHNW", "EEINSU", "EHRTVW", "EIOSST", "ELRTTY", "HIMNQU", "HLNNRZ"};
+
+static const char *const BigBoggleCubes[25]  =
+{"AAAFRS", "AAEEEE", "AAFIRS", "ADENNN", "AEEEEM", "AEEGMU", "AEGMNN", "AFIRSY",
+	"BJKQXZ", "CCNSTW", "CEIILT", "CEILPT", "CEIPST", "DDLNOR", "DDHNOT", "DHHLOR",
+	"DHLNOR", "EIIITT", "EMOTTT", "ENSSSU", "FIPRSY", "GORRVW", "HIPRRY", "NOOTUW", "OOOTTU"};
+
+
+template <> const char *Board<4, 4>::cubeFaces(int cube)
+{
+	return StandardCubes[cube];
+}
+
+template <> const char *Board<5, 5>::cubeFaces(int cube)
+{
+	return BigBoggleCubes[cube];
+}
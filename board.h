@@ -0,0 +1,286 @@
+/*
+ * File: board.h
+ * -------------
+ * Defines the Board class template, a Boggle board whose dimensions are
+ * fixed at compile time, along with the two sizes the game is played at.
+ */
+
+#ifndef _board_h
+#define _board_h
+
+#include "genlib.h"
+#include "random.h"
+#include "boardtopology.h"
+#include "fastrandom.h"
+#include <cctype>
+
+
+/*
+ * Class: Board
+ * ------------
+ * A board holds one letter per cube, as a single byte, in row-major order
+ * with cells numbered as in BoardTopology. Because the dimensions are
+ * template arguments, the cell count and the row and column arithmetic
+ * are constants the compiler can fold, and the neighbor lists are shared
+ * by every board of the size. Alongside the letters the board keeps, for
+ * each letter, the set of cells that show it, so together with the
+ * neighbor sets a search can find the cells it may step to next in a
+ * few bit operations. Nothing is allocated, so boards are cheap
+ * to make and copy. Sample use:
+ *
+ *	StandardBoard board;
+ *	board.shake();
+ *	for (int i = 0; i < StandardBoard::numNeighbors(cell); i++) {
+ *		char next = board.letterAt(StandardBoard::neighbor(cell, i));
+ *		...
+ */
+
+template <int Rows, int Cols>
+class Board {
+
+  public:
+
+    enum { NUM_ROWS = Rows, NUM_COLS = Cols, NUM_CELLS = Rows * Cols };
+
+   /*
+    * Constructor: Board
+    * Usage: StandardBoard board;
+    * ---------------------------
+    * The constructor makes a board with a blank on every cube.
+    */
+    Board();
+
+    static int numRows() { return Rows; }
+    static int numCols() { return Cols; }
+    static int numCells() { return NUM_CELLS; }
+
+    static int cellAt(int row, int col) { return row * Cols + col; }
+    static int rowOf(int cell) { return cell / Cols; }
+    static int colOf(int cell) { return cell % Cols; }
+
+   /*
+    * Static member functions: numNeighbors, neighbor, neighborMask
+    * Usage: int next = Board<4, 4>::neighbor(cell, i);
+    * -------------------------------------------------
+    * These functions give the number of cubes adjacent to the given cell,
+    * the index of the i-th one, in row-major order, and all of them as a
+    * set.
+    */
+    static int numNeighbors(int cell) { return topology.numNeighbors(cell); }
+    static int neighbor(int cell, int index) { return topology.neighbor(cell, index); }
+    static cellSetT neighborMask(int cell) { return topology.neighborMask(cell); }
+
+   /*
+    * Member functions: letterAt, setLetterAt, operator()
+    * Usage: char ch = board.letterAt(cell);
+    *        board.setLetterAt(board.cellAt(row, col), 'Q');
+    * ----------------------------------------------------
+    * These member functions read and write the letter on a cube, by cell
+    * index or, for reading, by row and column. Writing goes through
+    * setLetterAt so that the sets of cells for each letter stay right.
+    * There is no bounds checking.
+    */
+    char letterAt(int cell) const { return letters[cell]; }
+    void setLetterAt(int cell, char ch);
+    char operator()(int row, int col) const { return letters[cellAt(row, col)]; }
+
+   /*
+    * Member functions: cellsWithLetter, cellsWithLetters
+    * Usage: cellSetT cells = board.cellsWithLetter('E');
+    * ---------------------------------------------------
+    * cellsWithLetter returns the set of cubes showing the given letter,
+    * case-insensitively, or the empty set for anything that isn't a
+    * letter. cellsWithLetters takes the letters as a mask, with bit 0 for
+    * 'a' (as Lexicon::Cursor::nextLetters returns them), and returns the
+    * cubes showing any of them.
+    */
+    cellSetT cellsWithLetter(char ch) const
+    {
+        unsigned int ord = tolower(ch) - 'a';
+        return (ord < 26) ? letterCells[ord] : 0;
+    }
+    cellSetT cellsWithLetters(unsigned int letters) const;
+
+   /*
+    * Member function: shake
+    * Usage: board.shake();
+    * ---------------------
+    * This member function rolls each of the size's cubes to a random face
+    * and then shuffles the cubes around the board, which it does by
+    * swapping every cell with one chosen at random.
+    */
+    void shake();
+
+   /*
+    * Member function: shake
+    * Usage: board.shake(rng);
+    * ------------------------
+    * This member function shakes the board with the given generator rather
+    * than the shared one behind random.h, so threads can shake boards of
+    * their own and a seed always deals the same boards. The cubes are
+    * put in a random order by a Fisher-Yates shuffle, so every order is
+    * equally likely, and each shows a random face.
+    */
+    void shake(FastRandom & rng);
+
+   /*
+    * Member function: setLetters
+    * Usage: board.setLetters("ABCDEFGHIJKLMNOP");
+    * --------------------------------------------
+    * This member function fills the board from the first NUM_CELLS
+    * characters of the string, in row-major order, converted to upper
+    * case. If the string is shorter than that, Error is called.
+    */
+    void setLetters(string config);
+
+   /*
+    * Static member functions: numFaces, cubeFace
+    * Usage: char ch = StandardBoard::cubeFace(cube, face);
+    * -----------------------------------------------------
+    * These functions describe the set of cubes for the size, one cube per
+    * cell numbered from 0: the number of faces on each cube and the letter
+    * on a given face. shake rolls the same cubes.
+    */
+    static int numFaces() { return NUM_FACES; }
+    static char cubeFace(int cube, int face) { return cubeFaces(cube)[face]; }
+
+   /*
+    * Member function: toString
+    * Usage: string config = board.toString();
+    * ----------------------------------------
+    * This member function returns the letters of the board in row-major
+    * order, in the form setLetters accepts.
+    */
+    string toString() const;
+
+  private:
+    char letters[NUM_CELLS];
+    cellSetT letterCells[26];		// the cells showing each letter from 'a' to 'z'
+
+    void indexLetters();
+
+    enum { NUM_FACES = 6 };
+
+    static const BoardTopology topology;
+
+    // The faces of each cube in the set for this size; defined only for
+    // the sizes that have a set of cubes.
+    static const char *cubeFaces(int cube);
+
+    // Fails to compile for boards with more cells than a cellSetT holds.
+    typedef char sizeCheck[(Rows > 0 && Cols > 0 && NUM_CELLS <= MAX_CELLS) ? 1 : -1];
+};
+
+
+/*
+ * Types: StandardBoard, BigBoard
+ * ------------------------------
+ * The 4x4 board of standard Boggle and the 5x5 board of Big Boggle.
+ * The templates that work on boards, such as SolveBoard and
+ * SolutionIndex, are compiled for these two in their .cpp files, so
+ * that clients only need the declarations in the headers.
+ */
+
+typedef Board<4, 4> StandardBoard;
+typedef Board<5, 5> BigBoard;
+
+template <> const char *Board<4, 4>::cubeFaces(int cube);
+template <> const char *Board<5, 5>::cubeFaces(int cube);
+
+
+/*
+ * The rest of the template has to be in the header so that it can be
+ * instantiated for any size; the cube sets are in board.cpp.
+ */
+
+template <int Rows, int Cols>
+  const BoardTopology Board<Rows, Cols>::topology(Rows, Cols);
+
+template <int Rows, int Cols>
+  Board<Rows, Cols>::Board()
+	{
+		for (int cell = 0; cell < NUM_CELLS; cell++)
+			letters[cell] = ' ';
+		indexLetters();
+	}
+
+template <int Rows, int Cols>
+  void Board<Rows, Cols>::setLetterAt(int cell, char ch)
+	{
+		unsigned int ord = tolower(letters[cell]) - 'a';
+		if (ord < 26) letterCells[ord] &= ~CellSetAdd(0, cell);
+		letters[cell] = ch;
+		ord = tolower(ch) - 'a';
+		if (ord < 26) letterCells[ord] = CellSetAdd(letterCells[ord], cell);
+	}
+
+template <int Rows, int Cols>
+  cellSetT Board<Rows, Cols>::cellsWithLetters(unsigned int letters) const
+	{
+		cellSetT cells = 0;
+		for (; letters != 0; letters &= letters - 1)
+			cells |= letterCells[CellSetFirst(letters)];	// the lowest letter left, found as a cell would be
+		return cells;
+	}
+
+// Works out the cells for each letter from scratch.
+template <int Rows, int Cols>
+  void Board<Rows, Cols>::indexLetters()
+	{
+		for (int ord = 0; ord < 26; ord++)
+			letterCells[ord] = 0;
+		for (int cell = 0; cell < NUM_CELLS; cell++) {
+			unsigned int ord = tolower(letters[cell]) - 'a';
+			if (ord < 26) letterCells[ord] = CellSetAdd(letterCells[ord], cell);
+		}
+	}
+
+template <int Rows, int Cols>
+  void Board<Rows, Cols>::shake()
+	{
+		for (int cell = 0; cell < NUM_CELLS; cell++)
+			letters[cell] = cubeFaces(cell)[RandomInteger(0, NUM_FACES - 1)];
+		for (int cell = 0; cell < NUM_CELLS; cell++) {
+			int row = RandomInteger(0, Rows - 1);
+			int col = RandomInteger(0, Cols - 1);
+			char ch = letters[cell];
+			letters[cell] = letters[cellAt(row, col)];
+			letters[cellAt(row, col)] = ch;
+		}
+		indexLetters();
+	}
+
+template <int Rows, int Cols>
+  void Board<Rows, Cols>::shake(FastRandom & rng)
+	{
+		int cubeAt[NUM_CELLS];
+		for (int cell = 0; cell < NUM_CELLS; cell++)
+			cubeAt[cell] = cell;
+		for (int cell = NUM_CELLS - 1; cell > 0; cell--) {
+			int other = rng.nextInt(0, cell);
+			int cube = cubeAt[cell];
+			cubeAt[cell] = cubeAt[other];
+			cubeAt[other] = cube;
+		}
+		for (int cell = 0; cell < NUM_CELLS; cell++)
+			letters[cell] = cubeFaces(cubeAt[cell])[rng.nextInt(0, NUM_FACES - 1)];
+		indexLetters();
+	}
+
+template <int Rows, int Cols>
+  void Board<Rows, Cols>::setLetters(string config)
+	{
+		if (config.length() < NUM_CELLS)
+			Error("Board configuration has too few letters: " + config);
+		for (int cell = 0; cell < NUM_CELLS; cell++)
+			letters[cell] = toupper(config[cell]);
+		indexLetters();
+	}
+
+template <int Rows, int Cols>
+  string Board<Rows, Cols>::toString() const
+	{
+		return string(letters, NUM_CELLS);
+	}
+
+#endif
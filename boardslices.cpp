@@ -0,0 +1,86 @@
+/*
+ * File: boardslices.cpp
+ * ---------------------
+ * Implements the BoardSlices class template.
+ */
+
+#include "boardslices.h"
+#include "bogglesolver.h"
+#include <cctype>
+
+
+template <typename BoardType>
+  BoardSlices<BoardType>::BoardSlices()
+{
+	clear();
+}
+
+template <typename BoardType>
+  void BoardSlices<BoardType>::clear()
+{
+	numBoards = 0;
+	for (int ord = 0; ord < 26; ord++) {
+		for (int cell = 0; cell < BoardType::NUM_CELLS; cell++)
+			slices[ord][cell] = 0;
+	}
+}
+
+template <typename BoardType>
+  int BoardSlices<BoardType>::add(const BoardType & board)
+{
+	if (numBoards == MAX_BOARDS)
+		Error("BoardSlices can't hold more than 64 boards.");
+	boards[numBoards] = board;
+	for (int cell = 0; cell < BoardType::NUM_CELLS; cell++) {
+		unsigned int ord = tolower(board.letterAt(cell)) - 'a';
+		if (ord < 26) slices[ord][cell] |= 1ULL << numBoards;
+	}
+	return numBoards++;
+}
+
+template <typename BoardType>
+  boardSetT BoardSlices<BoardType>::boardsWithWord(const string & word)
+{
+	if (word.empty() || word.length() > BoardType::NUM_CELLS) return 0;
+	boardSetT reached[BoardType::NUM_CELLS];	// the boards on which the letters so far can end at each cell
+	bool repeats = false;
+	unsigned int seen = 0;
+	for (int i = 0; i < word.length(); i++) {
+		unsigned int ord = tolower(word[i]) - 'a';
+		if (ord >= 26) return 0;
+		if (seen & (1u << ord)) repeats = true;
+		seen |= 1u << ord;
+		boardSetT next[BoardType::NUM_CELLS], any = 0;
+		for (int cell = 0; cell < BoardType::NUM_CELLS; cell++) {
+			boardSetT from = ~0ULL;				// any cell can start the word
+			if (i > 0) {
+				from = 0;
+				for (int k = 0; k < BoardType::numNeighbors(cell); k++)
+					from |= reached[BoardType::neighbor(cell, k)];
+			}
+			next[cell] = slices[ord][cell] & from;
+			any |= next[cell];
+		}
+		if (any == 0) return 0;
+		for (int cell = 0; cell < BoardType::NUM_CELLS; cell++)
+			reached[cell] = next[cell];
+	}
+	boardSetT found = 0;
+	for (int cell = 0; cell < BoardType::NUM_CELLS; cell++)
+		found |= reached[cell];
+	if (repeats) {
+		int path[BoardType::NUM_CELLS];
+		for (boardSetT left = found; left != 0; left &= left - 1) {
+			int index = 0;
+			while (!((left >> index) & 1)) index++;
+			if (!FindWordPath(boards[index], word, path)) found &= ~(1ULL << index);
+		}
+	}
+	return found;
+}
+
+
+// Compiled for the board sizes in board.h (see StandardBoard).
+
+template class BoardSlices<StandardBoard>;
+template class BoardSlices<BigBoard>;
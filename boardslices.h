@@ -0,0 +1,89 @@
+/*
+ * File: boardslices.h
+ * -------------------
+ * Defines the BoardSlices class template, which holds a group of boards
+ * of one size so that a word can be checked against all of them at once,
+ * for jobs that grade the same words on many boards.
+ */
+
+#ifndef _boardslices_h
+#define _boardslices_h
+
+#include "genlib.h"
+#include "board.h"
+
+
+/*
+ * Type: boardSetT
+ * ---------------
+ * A set of the boards in a BoardSlices, one bit per board index.
+ */
+typedef unsigned long long boardSetT;
+
+
+/*
+ * Class: BoardSlices
+ * ------------------
+ * A group holds up to MAX_BOARDS boards bit-sliced: for each letter and
+ * each cell, the set of boards that show the letter on that cell, as one
+ * 64-bit word. Checking a word then steps through its letters once for
+ * the whole group, each cell's set for the next letter being the boards
+ * that show it there and could have reached a neighbor so far, so every
+ * operation works on all the boards side by side. That tracing doesn't
+ * stop a path from using a cube twice, so for a word with a repeated
+ * letter the boards it leaves are checked one at a time with
+ * FindWordPath; a word without one can't reuse a cube anyway. Sample use:
+ *
+ *	BoardSlices<StandardBoard> group;
+ *	for (int i = 0; i < numBoards; i++)
+ *		group.add(boards[i]);
+ *	boardSetT found = group.boardsWithWord("tiger");
+ *
+ * The template is compiled for StandardBoard and BigBoard in
+ * boardslices.cpp.
+ */
+
+template <typename BoardType>
+  class BoardSlices {
+
+  public:
+
+    enum { MAX_BOARDS = 64 };
+
+   /*
+    * Constructor: BoardSlices
+    * Usage: BoardSlices<BigBoard> group;
+    * -----------------------------------
+    * The constructor makes an empty group.
+    */
+    BoardSlices();
+
+   /*
+    * Member functions: add, size, clear
+    * Usage: int index = group.add(board);
+    * ------------------------------------
+    * add puts a copy of the board in the group and returns its index,
+    * which is its bit in the sets boardsWithWord returns. Adding to a
+    * group that already holds MAX_BOARDS boards is an error. size returns
+    * the number of boards, and clear empties the group.
+    */
+    int add(const BoardType & board);
+    int size() const { return numBoards; }
+    void clear();
+
+   /*
+    * Member function: boardsWithWord
+    * Usage: if (group.boardsWithWord(word) & (1ULL << index))...
+    * -----------------------------------------------------------
+    * This member function returns the set of boards in the group on which
+    * the word can be traced, by the same rules as FindWordPath.
+    */
+    boardSetT boardsWithWord(const string & word);
+
+  private:
+    BoardType boards[MAX_BOARDS];
+    int numBoards;
+    boardSetT slices[26][BoardType::NUM_CELLS];	// for each letter and cell, the boards showing it there
+};
+
+#endif
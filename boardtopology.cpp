@@ -0,0 +1,42 @@
+/*
+ * File: boardtopology.cpp
+ * -----------------------
+ * Implements the BoardTopology class.
+ */
+
+#include "boardtopology.h"
+
+
+BoardTopology::BoardTopology(int numRows, int numCols)
+{
+	if (numRows <= 0 || numRows > MAX_DIMENSION || numCols <= 0 || numCols > MAX_DIMENSION)
+		Error("BoardTopology created with invalid dimensions.");
+	rows = numRows;
+	cols = numCols;
+	for (int cell = 0; cell < numCells(); cell++) {
+		neighborCount[cell] = 0;
+		neighborMasks[cell] = 0;
+		for (int row = rowOf(cell) - 1; row <= rowOf(cell) + 1; row++) {
+			for (int col = colOf(cell) - 1; col <= colOf(cell) + 1; col++) {
+				if (row < 0 || row >= rows || col < 0 || col >= cols) continue;	// off the board
+				if (row == rowOf(cell) && col == colOf(cell)) continue;		// a cube isn't its own neighbor
+				neighbors[cell][neighborCount[cell]++] = cellAt(row, col);
+				neighborMasks[cell] = CellSetAdd(neighborMasks[cell], cellAt(row, col));
+			}
+		}
+	}
+}
+
+// Topologies are built lazily and kept for the life of the program. The
+// first request for a size must not race with another, so multi-threaded
+// clients should ask for it before starting their workers.
+const BoardTopology & BoardTopology::forSize(int numRows, int numCols)
+{
+	static BoardTopology *cache[MAX_DIMENSION][MAX_DIMENSION];
+
+	if (numRows <= 0 || numRows > MAX_DIMENSION || numCols <= 0 || numCols > MAX_DIMENSION)
+		Error("BoardTopology requested with invalid dimensions.");
+	BoardTopology *&topology = cache[numRows - 1][numCols - 1];
+	if (!topology) topology = new BoardTopology(numRows, numCols);
+	return *topology;
+}
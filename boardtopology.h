@@ -0,0 +1,143 @@
+/*
+ * File: boardtopology.h
+ * ---------------------
+ * Defines the BoardTopology class, which records which cubes on a board
+ * of a given size are neighbors of one another, along with a small
+ * fixed-width set type for marking cubes as used.
+ */
+
+#ifndef _boardtopology_h
+#define _boardtopology_h
+
+#include "genlib.h"
+#include "gboggle.h"	// for MAX_DIMENSION
+
+
+/*
+ * Constant: MAX_CELLS
+ * -------------------
+ * The largest number of cubes a board can have.
+ */
+const int MAX_CELLS = MAX_DIMENSION * MAX_DIMENSION;
+
+/*
+ * Constant: MAX_NEIGHBORS
+ * -----------------------
+ * A cube touches at most eight others: horizontally, vertically and
+ * diagonally.
+ */
+const int MAX_NEIGHBORS = 8;
+
+
+/*
+ * Type: cellSetT
+ * --------------
+ * A set of cubes, stored as one bit per cell index. Every board up to
+ * MAX_DIMENSION x MAX_DIMENSION fits, so copying, testing and adding to
+ * a set never allocates.
+ */
+typedef unsigned int cellSetT;
+
+inline bool CellSetContains(cellSetT set, int cell) { return (set >> cell) & 1; }
+inline cellSetT CellSetAdd(cellSetT set, int cell) { return set | (1u << cell); }
+
+/*
+ * Function: CellSetFirst
+ * Usage: int cell = CellSetFirst(set);
+ * ------------------------------------
+ * This function returns the lowest cell in a set that isn't empty, so a
+ * loop can take the cells of a set in row-major order:
+ *
+ *	for (cellSetT left = set; left != 0; left &= left - 1) {
+ *		int cell = CellSetFirst(left);
+ *		...
+ */
+inline int CellSetFirst(cellSetT set)
+{
+#if defined(__GNUC__)
+	return __builtin_ctz(set);
+#else
+	int cell = 0;
+	while (!(set & 1)) {
+		set >>= 1;
+		cell++;
+	}
+	return cell;
+#endif
+}
+
+
+/*
+ * Class: BoardTopology
+ * --------------------
+ * A topology numbers the cubes of a board from 0 to numCells()-1 in
+ * row-major order and stores, for each cube, the list of cubes adjacent
+ * to it. It depends only on the board dimensions, so it is built once per
+ * size and shared. A typical search steps through the neighbors like so,
+ * or takes them all at once as a set from neighborMask:
+ *
+ *	const BoardTopology & topology = BoardTopology::forSize(4, 4);
+ *	for (int i = 0; i < topology.numNeighbors(cell); i++) {
+ *		int next = topology.neighbor(cell, i);
+ *		...
+ */
+
+class BoardTopology {
+
+  public:
+
+   /*
+    * Static member function: forSize
+    * Usage: const BoardTopology & topology = BoardTopology::forSize(4, 4);
+    * ---------------------------------------------------------------------
+    * This function returns the shared topology for boards of the given
+    * dimensions, building it the first time that size is asked for. If
+    * either dimension is <= 0 or > MAX_DIMENSION, Error is called.
+    */
+    static const BoardTopology & forSize(int numRows, int numCols);
+
+   /*
+    * Constructor: BoardTopology
+    * Usage: BoardTopology topology(5, 5);
+    * ------------------------------------
+    * The constructor computes the neighbor lists for a board of the given
+    * dimensions. Most clients should use forSize instead.
+    */
+    BoardTopology(int numRows, int numCols);
+
+    int numRows() const { return rows; }
+    int numCols() const { return cols; }
+    int numCells() const { return rows * cols; }
+
+    int cellAt(int row, int col) const { return row * cols + col; }
+    int rowOf(int cell) const { return cell / cols; }
+    int colOf(int cell) const { return cell % cols; }
+
+   /*
+    * Member functions: numNeighbors, neighbor
+    * Usage: int next = topology.neighbor(cell, i);
+    * ---------------------------------------------
+    * These member functions give the number of cubes adjacent to the
+    * given cell and the index of the i-th one, in row-major order.
+    */
+    int numNeighbors(int cell) const { return neighborCount[cell]; }
+    int neighbor(int cell, int index) const { return neighbors[cell][index]; }
+
+   /*
+    * Member function: neighborMask
+    * Usage: cellSetT next = topology.neighborMask(cell) & ~visited;
+    * --------------------------------------------------------------
+    * This member function returns the cubes adjacent to the given cell as
+    * a set, so a search can rule out visited cubes, or cubes with the
+    * wrong letters, in a single operation instead of one at a time.
+    */
+    cellSetT neighborMask(int cell) const { return neighborMasks[cell]; }
+
+  private:
+    int rows, cols;
+    int neighborCount[MAX_CELLS];
+    int neighbors[MAX_CELLS][MAX_NEIGHBORS];
+    cellSetT neighborMasks[MAX_CELLS];
+};
+
+#endif
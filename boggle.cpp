@@ -1,50 +1,37 @@
 /* File: boggle.cpp
  * ----------------
  * This program plays the board game Boggle. 
- * Generally speaking, it uses a Grid container to
+ * Generally speaking, it uses a Board to
  * represent the board internally, while using
- * a graphical display for the user.
+ * a graphical display for the user. The game is
+ * played on either the standard 4x4 board or the
+ * 5x5 Big Boggle board, so the functions that deal
+ * with the board are templates on its type.
  */
  
 #include "genlib.h"
 #include "simpio.h"
 #include <iostream>
 #include "extgraph.h"
-#include "grid.h"
-#include "random.h"
 #include "lexicon.h"
 #include "gboggle.h"
 #include "strutils.h"
-#include "set.h"
+#include "wordhashset.h"
+#include "board.h"
+#include "bogglesolver.h"
+#include "solutionindex.h"
+#include "solutioncache.h"
+#include "sharedlexicon.h"
+#include "bogglestats.h"
 
 
 /* Constants
  * ---------
  */
 
-string StandardCubes[16]  = 
-{"AAEEGN", "ABBJOO", "ACHOPS", "AFFKPS", "AOOTTW", "CIMOTU", "DEILRX", "DELRVY",
-	"DISTTY", "EEGHNW", "EEINSU", "EHRTVW", "EIOSST", "ELRTTY", "HIMNQU", "HLNNRZ"};
+const double HIGHLIGHT_SECONDS = .5;	// how long the cubes of an accepted word stay lit
+const int BOARDS_REMEMBERED = 16;		// solutions kept for boards that come up again
 
-string BigBoggleCubes[25]  = 
-{"AAAFRS", "AAEEEE", "AAFIRS", "ADENNN", "AEEEEM", "AEEGMU", "AEGMNN", "AFIRSY", 
-	"BJKQXZ", "CCNSTW", "CEIILT", "CEILPT", "CEIPST", "DDLNOR", "DDHNOT", "DHHLOR", 
-	"DHLNOR", "EIIITT", "EMOTTT", "ENSSSU", "FIPRSY", "GORRVW", "HIPRRY", "NOOTUW", "OOOTTU"};
-
-
-/* Structures
- * ----------
- */
-
-/* Struct: locationT
- * ----------------
- * Condenses a row and column into one struct
- */
-
-struct locationT {
-	int numRow;
-	int numCol;
-};
 
 /* Part 1: Instructions
  * -------------------
@@ -80,177 +67,108 @@ static void Welcome()
  */
 
 
-/* Function: InitializeBoard
- * ---------
- * This function initialized the board. It first assigns a random letter from each
- * cube to a spot on the board. It then randomly swaps all the letters so that
- * the same cube is not in the same place every time. Finally, it updates
- * the graphics display.
+/* Function: LabelBoard
+ * ---------------------
+ * This function updates the graphics display to show the letters on the board.
  */
 
-void InitializeBoard(Grid<string> &board) {
-	//assign each location a letter
+template <typename BoardType>
+  void LabelBoard(const BoardType & board) {
+	STATS_TIME_PHASE(RenderPhase);
 	for (int i = 0; i < board.numRows(); i++) {
 		for (int j = 0; j < board.numCols(); j++) {
-			int RandNum = RandomInteger(0,5);									//change if big board
-			board(i,j) = StandardCubes[i * board.numCols() + j][RandNum];		//pick a random letter from each of the 16 cubes
+			LabelCube(i, j, board(i,j));
 		}
 	}
-	//swap letters randomly so that each letter is swapped at least once
-	for (int i = 0; i < board.numRows(); i++) {						
-		for (int j = 0; j < board.numCols(); j++) {
-			int RandRow = RandomInteger(0, board.numRows() - 1);
-			int RandCol = RandomInteger(0, board.numCols() - 1);
-			string s1 = board(i,j);
-			string s2 = board(RandRow, RandCol);
-			board(i,j) = s2;
-			board(RandRow, RandCol) = s1;
-		}
-	}
-	//update graphics
-	for (int i = 0; i < board.numRows(); i++) {
-		for (int j = 0; j < board.numCols(); j++) {
-			LabelCube(i, j, board(i,j)[0]);
-		}
+}
+
+/* Function: InitializeBoard
+ * ---------
+ * This function initialized the board. It rolls each cube to a random letter
+ * and shuffles the cubes so that the same cube is not in the same place every
+ * time (see Board::shake). Finally, it updates the graphics display.
+ */
+
+template <typename BoardType>
+  void InitializeBoard(BoardType &board) {
+	{
+		STATS_TIME_PHASE(BoardPhase);
+		board.shake();
 	}
-	
+	LabelBoard(board);
 }
 
 /* Function: UserConfigureBoard
  * ---------------------------
  * This function allows the user to input the letters they want to use in the board.
- * It does so by asking for 16 letters, checking to make sure the configuration has
- * at least that many letters. It then places the letters in the grid and
+ * It does so by asking for one letter per cube, checking to make sure the configuration
+ * has at least that many letters. It then places the letters in the board and
  * updates the display.
  */
 
-void UserConfigureBoard(Grid<string> &board) {
+template <typename BoardType>
+  void UserConfigureBoard(BoardType &board) {
 	string config;
 	while (true) {
-		cout << "Please enter your configuration. It must be 16 letters: " << endl;
+		cout << "Please enter your configuration. It must be " << board.numCells() << " letters: " << endl;
 		config = ConvertToUpperCase(GetLine());
-		if (config.length() > 15) break;
+		if (config.length() >= board.numCells()) break;
 		cout << "String too short. Enter another string" << endl;
 	}
-	if (config.length() > 16) { //truncate string to 16 letters
-		config = config.substr(0, 16);
-	}
-	for (int i = 0; i < board.numRows(); i++) { //assign each letter to proper space in board
-		for (int j = 0; j < board.numCols(); j++) {
-			board(i,j) = config[i * board.numCols() + j];
-		}
-	}
-	for (int i = 0; i < board.numRows(); i++) { //update display
-		for (int j = 0; j < board.numCols(); j++) {
-			LabelCube(i, j, board(i,j)[0]);
-		}
+	{
+		STATS_TIME_PHASE(BoardPhase);
+		board.setLetters(config);		//extra letters are ignored
 	}
+	LabelBoard(board);
 }
 
 
-/* Part 3: Player's turn
+/* Function: IndexBoard
  * ---------------------
+ * This function solves the finished board once, on all of the processors,
+ * and keeps every word on it with its path in solution, so that the
+ * player's words and the computer's turn need no more searching. A board
+ * the user has configured before, even turned or flipped, is taken from
+ * the cache instead of being solved again.
  */
 
-/* Function: AreNeighbors
- * ---------------------------
- * This function checks to see if two locations on the board are neighbors.
- * It returns true if the two neighbors are immediately adjacent on the board.
- */
-
-bool AreNeighbors(int row1, int col1, int row2, int col2) {
-	if (row2 == -1 && col2 == -1) {							//sentinel values passed for the first cube
-		return true;
-	} else if (row1 - row2 > 1 || row2 - row1 > 1 || col1 - col2 > 1 || col2 - col1 > 1) { // if any dimensions are more than
-		return false;																	   // one apart, return false
-	} else if (row1 == row2 && col1 == col2) {
-		return false;										//if the cube is checking itself, return false
-	} else {
-		return true;
-	}
+template <typename BoardType>
+  void IndexBoard(const BoardType & board, const Lexicon & lex, SolutionCache<BoardType> & cache,
+				  SolutionIndex<BoardType> & solution) {
+	STATS_TIME_PHASE(SolvePhase);
+	ThreadPool pool;
+	cache.solve(board, lex, pool, solution);
 }
 
 
-/* Function: NotDuplicated
- * ---------------------------
- * This function checks to see if a letter has already been used.
- * It checks a given row and column against a list of all the locations
- * already used for that word. 
- */
-
-bool NotDuplicated(int row, int col, Vector<locationT> & locations) {
-	for (int i = 0; i < locations.size(); i++) {
-		if (locations[i].numRow == row && locations[i].numCol == col) {
-			return false;
-		}
-	}
-	return true;
-}
-
-/* Function: Findable
- * ---------------------------
- * This function checks to see if a word entered by the user can be found in the puzzle. 
- * It works by checking that each successive letter in the word is both a neighbor to the
- * last letter and has not been used before. In the process, it keeps track of the location
- * of each letter so that it can highlight the word on the board. There is an additional 
- * vector that keeps track of solutions because there are often multiple ways to get a word.
+/* Part 3: Player's turn
+ * ---------------------
  */
 
-void Findable(Grid<string> & board, string word, int row, int col, Vector<locationT> locations, Vector<Vector<locationT> > & answers) {
-	word = ConvertToUpperCase(word);
-	if (word.size() == 0) {							//every letter has been found, so add the locations to the set of answers
-		answers.add(locations);
-	}
-	for (int i = 0; i < board.numRows(); i++) {
-		for (int j = 0; j < board.numCols(); j++) {
-			if (board(i,j) == word.substr(0,1) &&	//checks that the next letter is at a location, that it is a neighbor of the last letter
-				AreNeighbors(i,j,row,col) && NotDuplicated(i,j, locations)) {			//and that it hasn't been used before
-				locationT location;
-				location.numRow = i;
-				location.numCol = j;
-				locations.add(location);
-				Findable(board, word.substr(1), i, j, locations, answers);		//recurs with a truncated word and updated location
-				if (word.size() != 0) {
-					locations.removeAt(locations.size() - 1);			//word wasn't found going down this path, so remove the letter from 
-				}														//the list of letters already seen
-			}
-		}
-	}
-}
-
-
 /* Function: WordIsValid
  * ---------------------------
  * This function checks to see if a word is valid based on four criteria:
  * it is more than 3 letters, it is a real word, it hasn't been found before,
- * and it can be found in the puzzle.
+ * and it can be found in the puzzle. All but the third are the rules in
+ * CheckWord, which the board's solution answers with a lookup. The path
+ * it keeps is the first way to trace the word, which is the one that gets
+ * highlighted.
  */
 
-bool WordIsValid(string word, Grid<string> & board, Lexicon & lex, Set<string> & wordsSeen) {
-	if (word.length() < 4) {
+template <typename BoardType>
+  bool WordIsValid(string word, const BoardType & board, SolutionIndex<BoardType> & solution, WordHashSet & wordsSeen) {
+	STATS_TIME_PHASE(ValidatePhase);
+	if (wordsSeen.contains(word)) {		//already seen the word
 		return false;
-	} else if (wordsSeen.contains(word)) {		//already seen the word
-		return false;	
-	} else if (!lex.containsWord(word)) {		//not a word according to the dictionary
+	}
+	typename SolutionIndex<BoardType>::pathT path;
+	if (solution.check(word, path) != WordAccepted) {		//too short, not a word or not in the puzzle
 		return false;
-	} else {
-		Vector<locationT> empty;
-		Vector<Vector<locationT> > results;
-		Findable(board, word, -1, -1, empty, results);
-		if (results.size() == 0) {							//no paths were found for the word, so word can't be found
-			return false;
-		} else {
-			Vector<locationT> answer = results[0];			//at least one path was found, so return true and highlight the cubes
-			for (int i = 0; i < answer.size(); i++) {
-				HighlightCube(answer[i].numRow, answer[i].numCol, true);
-			}
-			Pause(.5);
-			for (int i = 0; i < answer.size(); i++) {		//then un-highlight the cubes
-				HighlightCube(answer[i].numRow, answer[i].numCol, false);
-			}
-			return true;
-		}
 	}
+	for (int i = 0; i < path.size(); i++) {		//a path was found, so return true and flash the cubes, which
+		FlashCube(board.rowOf(path[i]), board.colOf(path[i]), HIGHLIGHT_SECONDS);	//go back to normal with the next word
+	}
+	return true;
 }
 
 /* Function: putWordOnBoard
@@ -259,7 +177,8 @@ bool WordIsValid(string word, Grid<string> & board, Lexicon & lex, Set<string> &
  * updates the list of words that have been found already
  */
 
-void putWordOnBoard(Grid<string> & board, string word, Set<string> & wordsSeen) {
+void putWordOnBoard(string word, WordHashSet & wordsSeen) {
+	STATS_TIME_PHASE(RenderPhase);
 	wordsSeen.add(word);
 	RecordWordForPlayer(word, Human);
 }
@@ -274,18 +193,20 @@ void putWordOnBoard(Grid<string> & board, string word, Set<string> & wordsSeen)
  * and updates the player's score.
  */
 
-void PlayerTurn(Grid<string> & board, Lexicon & lex, Set<string> & wordsSeen) {
+template <typename BoardType>
+  void PlayerTurn(const BoardType & board, SolutionIndex<BoardType> & solution, WordHashSet & wordsSeen) {
 	while (true) {
 		cout << "Please enter a word found in the puzzle (ENTER to finish): ";
 		string word = GetLine();
 		word = ConvertToUpperCase(word);
 		if (word == "") break;
-		if (WordIsValid(word, board, lex, wordsSeen)) {
-			putWordOnBoard(board, word, wordsSeen);
+		if (WordIsValid(word, board, solution, wordsSeen)) {
+			putWordOnBoard(word, wordsSeen);
 		} else {
 			cout << "Sorry, that word is invalid. ";
 		}
 	}
+	EndFlashes();			// don't leave the last word lit into the computer's turn
 }
 
 
@@ -294,91 +215,94 @@ void PlayerTurn(Grid<string> & board, Lexicon & lex, Set<string> & wordsSeen) {
  * The computer finds all the remaining words in the puzzle
  */
 
-/* Function: FindAllWords
- * ---------------------------
- * This function finds all the remaining words in the puzzle. It starts in the top left of the puzzle
- * and finds every word that can be found from each successive position, calling itself recursively. 
- * The function bottoms out if the dictionary doesn't contain any words with the prefix that is 
- * being explored or when the computer has run off the grid. 
- */
-
-void FindAllWords(int row, int col, Grid<string> & board, Lexicon & lex, Set<string> & wordsSeen, string soFar, Vector<locationT> visited) {
-	locationT here;
-	here.numRow = row;
-	here.numCol = col;
-	visited.add(here);							
-	soFar += board(row,col);					
-	if (!lex.containsPrefix(soFar)) {			//return if this is a dead end
-		return;
-	}
-	if (lex.containsWord(soFar) && (!wordsSeen.contains(soFar)) && soFar.size() > 3) {
-		RecordWordForPlayer(soFar, Computer);			//found a word, so record it
-		wordsSeen.add(soFar);
-	}
-	for (int i = 0; i < board.numRows(); i++) {
-		for (int j = 0; j < board.numCols(); j++) {
-			if (AreNeighbors(row, col, i, j) && NotDuplicated(i, j, visited)) {		//recur on the rest of the puzzle for all 
-				FindAllWords(i, j, board, lex, wordsSeen, soFar, visited);			//neighbors that haven't already been seen
-			}
-		}
-	}
-}
-
 /* Function: ComputerTurn
  * ---------------------------
- * This function completes the computer's turn by finding every word starting
- * from each position on the board.
+ * This function completes the computer's turn by taking every word in the
+ * board's solution that the player didn't find, in the order the search
+ * came across them, and recording them together.
  */
 	
-void ComputerTurn(Grid<string> & board, Lexicon & lex, Set<string> & wordsSeen) {	
-	for (int i = 0; i < board.numRows(); i++) {
-		for (int j = 0; j < board.numCols(); j++) {
-			Vector<locationT> empty;
-			FindAllWords(i, j, board, lex, wordsSeen, "", empty);
-		}
-	}
+template <typename BoardType>
+  void ComputerTurn(SolutionIndex<BoardType> & solution, WordHashSet & wordsSeen) {
+	Vector<string> found;
+	solution.findRemaining(wordsSeen, found);
+	STATS_TIME_PHASE(RenderPhase);
+	RecordWordsForPlayer(found, Computer);
 }
 			
 /* Part 5: Main Function
  * --------------------
  */
 
+/* Function: PlayGame
+ * ---------------------------
+ * This function plays one game on a board of the given type. It draws the
+ * board, asking the user if he wants to configure it, and solves it once
+ * it is set up. It then allows the user to play before having the computer
+ * go and find the rest of the words.
+ */
+
+template <typename BoardType>
+  void PlayGame(const Lexicon & lex, SolutionCache<BoardType> & cache) {
+	WordHashSet wordsSeen;
+	BoardType board;
+	SolutionIndex<BoardType> solution;
+	{
+		STATS_TIME_PHASE(RenderPhase);
+		DrawBoard(board.numRows(), board.numCols());
+	}
+	
+	//either set up the board automatically or let the user set it up
+	cout << "Would you like to configure the board? ";
+	string response = GetLine();
+	response = ConvertToUpperCase(response);
+	if (response == "YES") {
+		UserConfigureBoard(board);
+	} else {
+		InitializeBoard(board);
+	}
+	IndexBoard(board, lex, cache, solution);
+	
+	//have the player play, then the computer
+	PlayerTurn(board, solution, wordsSeen);
+	ComputerTurn(solution, wordsSeen);
+	STATS_ONLY(PrintBoggleStats(cout); ResetBoggleStats();)
+}
+
 /* Function: main
  * ---------------------------
- * This function controls the flow of the game. It initializes the dictionary
- * and the board, asking the user if he wants to configure the board. It then
- * allows the user to play before having the computer go and find the rest
- * of the words. It then asks the user if he wants to play again.
+ * This function controls the flow of the game. It initializes the dictionary,
+ * then asks the user whether to play Big Boggle and plays a game on the
+ * board of that size. It then asks the user if he wants to play again. The
+ * solutions of recent boards of each size are kept from game to game.
  */
 
 int main()
 {
+	SharedLexicon lex;
+	{
+		STATS_TIME_PHASE(LoadPhase);
+		lex = SharedLexicon::load("lexicon.dat");	//read the dictionary once for every game
+	}
+	SolutionCache<StandardBoard> standardCache(BOARDS_REMEMBERED);
+	SolutionCache<BigBoard> bigCache(BOARDS_REMEMBERED);
 	while (true) {
 		//initialize
 		Randomize();
-		Set<string> wordsSeen;
-		Lexicon lex("lexicon.dat");
-		Grid<string> board(4,4);			//changes for 5x5
 		SetWindowSize(9, 5);
 		InitGraphics();
-		DrawBoard(4,4);						//changes for 5x5
 		Welcome();
 		GiveInstructions();
 		
-		//either set up the board automatically or let the user set it up
-		cout << "Would you like to configure the board? ";
+		cout << "Would you like to play Big Boggle (5x5)? ";
 		string response = GetLine();
 		response = ConvertToUpperCase(response);
 		if (response == "YES") {
-			UserConfigureBoard(board);
+			PlayGame<BigBoard>(*lex, bigCache);
 		} else {
-			InitializeBoard(board);
+			PlayGame<StandardBoard>(*lex, standardCache);
 		}
 		
-		//have the player play, then the computer
-		PlayerTurn(board, lex, wordsSeen);
-		ComputerTurn(board, lex, wordsSeen);
-		
 		//check if the user wants to play again
 		cout << "Would you like to play again? ";
 		response = GetLine();
@@ -387,6 +311,3 @@ int main()
 	}
 	return 0;
 }
-
-
-
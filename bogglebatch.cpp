@@ -0,0 +1,242 @@
+/*
+ * File: bogglebatch.cpp
+ * ---------------------
+ * A command-line tool that solves Boggle boards in bulk, with no graphics.
+ * Boards are read one per line, either from the files named on the command
+ * line or from standard input, as 16 letters for a 4x4 board or 25 letters
+ * for a 5x5 board, the same way the game lets a user configure one. For
+ * each board it writes one line: by default the board, its total score,
+ * its word count and its words, separated by tabs (the words by spaces),
+ *
+ *	ABCDEFGHIJKLMNOP	10	8	fink fino glop jink knife knop mink plonk
+ *
+ * or, with -json, one JSON object per line:
+ *
+ *	{"board":"ABCDEFGHIJKLMNOP","score":10,"words":["fink","fino",...,"plonk"]}
+ *
+ * or, with -catalog, as one record each of a binary catalog file (see
+ * solutioncatalog.h), which bogglecatalog reads back. -paths adds the
+ * first path of each word to the records, and -shaken marks the boards
+ * as shaken from the game's cubes for their size.
+ *
+ * Usage: bogglebatch [-json | -catalog file [-paths] [-shaken]] [-prune]
+ *                    [-lexicon file] [-threads n] [file ...]
+ *
+ * Boards are solved in groups, one board per task on a thread pool, and
+ * the results are written in input order. The jobs of a group, and the
+ * words they hold, are kept from one group to the next, and each worker
+ * keeps its own set of the words seen, so once the first groups are done
+ * solving a board allocates nothing unless it is pruned. Lines that aren't a board are
+ * reported on standard error and skipped. With -prune, each board is
+ * solved against just the part of the lexicon that could be on it (see
+ * PruneLexiconForBoard); the output is the same either way.
+ */
+
+#include "genlib.h"
+#include "consoletool.h"
+#include "strutils.h"
+#include "board.h"
+#include "lexicon.h"
+#include "bogglesolver.h"
+#include "threadpool.h"
+#include "wordindexset.h"
+#include "wordarena.h"
+#include "solutioncatalog.h"
+#include <iostream>
+#include <fstream>
+#include <cctype>
+#include <cstdlib>
+#include <vector>
+
+
+/* Constants
+ * ---------
+ */
+
+const int BOARDS_PER_GROUP = 1024;	// boards read and solved together before any output
+
+
+/* Struct: boardJobT
+ * -----------------
+ * One board to be solved, along with the words found on it and their
+ * score, and their catalog record if the output is a catalog. A job is
+ * reused for a new board once its words are written.
+ */
+
+struct boardJobT {
+	string letters;
+	const Lexicon *lex;
+	bool prune;
+	std::vector<WordIndexSet> *seenByWorker;	// scratch space for each worker of the pool
+	WordArena words;
+	int score;
+	SolutionCatalogWriter *catalog;				// NULL unless writing a catalog
+	bool shaken;								// the board was shaken from the game's cubes
+	bool withPaths;
+	std::vector<unsigned char> record;
+};
+
+template <typename BoardType>
+  static void SolveLetters(boardJobT & job, int worker)
+{
+	BoardType board;
+	board.setLetters(job.letters);
+	Lexicon boardLex;
+	const Lexicon *lex = job.lex;
+	if (job.prune) {
+		PruneLexiconForBoard(board, *job.lex, boardLex);
+		lex = &boardLex;
+	}
+	WordIndexSet & seen = (*job.seenByWorker)[worker];
+	job.score = SolveBoardWords(board, *lex, seen, job.words);
+	if (job.catalog == NULL) return;
+	if (job.prune) {									// the catalog needs indexes in the whole lexicon
+		seen.clear();
+		for (int i = 0; i < job.words.size(); i++)
+			seen.add(job.lex->indexOf(job.words.wordAt(i)));
+	}
+	catalogCubesT cubes = UnknownCubes;
+	if (job.shaken) cubes = ((int)BoardType::NUM_CELLS == (int)BigBoard::NUM_CELLS) ? BigCubes : StandardCubes;
+	EncodeSolutionRecord(board, cubes, *job.lex, seen, job.withPaths, job.record);
+}
+
+static void SolveJob(void *data, int worker)
+{
+	boardJobT & job = *(boardJobT *)data;
+	if (job.letters.length() == BigBoard::NUM_CELLS) SolveLetters<BigBoard>(job, worker);
+	else SolveLetters<StandardBoard>(job, worker);
+}
+
+// Reduces a line to its letters in upper case. Returns false if what is
+// left isn't the right length for a board.
+static bool ParseBoard(string line, string & letters)
+{
+	letters = "";
+	for (int i = 0; i < line.length(); i++) {
+		if (isalpha(line[i])) letters += toupper(line[i]);
+		else if (!isspace(line[i])) return false;
+	}
+	return letters.length() == StandardBoard::NUM_CELLS || letters.length() == BigBoard::NUM_CELLS;
+}
+
+static void WriteJob(boardJobT & job, bool json)
+{
+	if (job.catalog != NULL) {
+		job.catalog->add(job.record);
+	} else if (json) {
+		cout << "{\"board\":\"" << job.letters << "\",\"score\":" << job.score << ",\"words\":[";
+		for (int i = 0; i < job.words.size(); i++) {
+			cout << (i > 0 ? "," : "") << '"' << job.words.wordAt(i) << '"';
+		}
+		cout << "]}\n";
+	} else {
+		cout << job.letters << '\t' << job.score << '\t' << job.words.size() << '\t';
+		for (int i = 0; i < job.words.size(); i++) {
+			cout << (i > 0 ? " " : "") << job.words.wordAt(i);
+		}
+		cout << '\n';
+	}
+}
+
+// Solves the first numJobs boards waiting in jobs and writes them out
+// in order.
+static void FlushJobs(std::vector<boardJobT> & jobs, int numJobs, ThreadPool & pool, bool json)
+{
+	for (int i = 0; i < numJobs; i++) {
+		pool.submit(SolveJob, &jobs[i]);
+	}
+	pool.wait();
+	for (int i = 0; i < numJobs; i++) {
+		WriteJob(jobs[i], json);
+	}
+}
+
+// Reads the boards of a stream into jobs, which holds BOARDS_PER_GROUP
+// of them, and solves each group as it fills.
+static void SolveStream(istream & in, string name, std::vector<boardJobT> & jobs, ThreadPool & pool, bool json)
+{
+	int numJobs = 0;
+	string line;
+	for (int lineNum = 1; getline(in, line); lineNum++) {
+		if (!ParseBoard(line, jobs[numJobs].letters)) {
+			if (!jobs[numJobs].letters.empty())
+				cerr << name << ":" << lineNum << ": not a 16- or 25-letter board, skipped" << endl;
+			continue;
+		}
+		if (++numJobs == BOARDS_PER_GROUP) {
+			FlushJobs(jobs, numJobs, pool, json);
+			numJobs = 0;
+		}
+	}
+	FlushJobs(jobs, numJobs, pool, json);
+}
+
+static void Usage()
+{
+	cerr << "Usage: bogglebatch [-json | -catalog file [-paths] [-shaken]] [-prune]" << endl
+		 << "                   [-lexicon file] [-threads n] [file ...]" << endl;
+	exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+	bool json = false, prune = false, withPaths = false, shaken = false;
+	string lexiconFile = "lexicon.dat", catalogFile;
+	int numThreads = 0;
+	int arg = 1;
+	for (; arg < argc && argv[arg][0] == '-' && argv[arg][1] != '\0'; arg++) {
+		string flag = argv[arg];
+		if (flag == "-json") {
+			json = true;
+		} else if (flag == "-prune") {
+			prune = true;
+		} else if (flag == "-catalog" && arg + 1 < argc) {
+			catalogFile = argv[++arg];
+		} else if (flag == "-paths") {
+			withPaths = true;
+		} else if (flag == "-shaken") {
+			shaken = true;
+		} else if (flag == "-lexicon" && arg + 1 < argc) {
+			lexiconFile = argv[++arg];
+		} else if (flag == "-threads" && arg + 1 < argc) {
+			numThreads = atoi(argv[++arg]);
+		} else {
+			Usage();
+		}
+	}
+	if ((json && !catalogFile.empty()) || ((withPaths || shaken) && catalogFile.empty())) Usage();
+	Lexicon lex(lexiconFile);
+	SolutionCatalogWriter *catalog = catalogFile.empty() ? NULL : new SolutionCatalogWriter(catalogFile, lex);
+	ThreadPool pool(numThreads);
+	std::vector<WordIndexSet> seenByWorker(pool.numWorkers());
+	std::vector<boardJobT> jobs(BOARDS_PER_GROUP);
+	for (int i = 0; i < jobs.size(); i++) {
+		jobs[i].lex = &lex;
+		jobs[i].prune = prune;
+		jobs[i].seenByWorker = &seenByWorker;
+		jobs[i].catalog = catalog;
+		jobs[i].shaken = shaken;
+		jobs[i].withPaths = withPaths;
+	}
+	if (arg == argc) {
+		SolveStream(cin, "stdin", jobs, pool, json);
+	}
+	for (; arg < argc; arg++) {
+		string name = argv[arg];
+		if (name == "-") {
+			SolveStream(cin, "stdin", jobs, pool, json);
+			continue;
+		}
+		ifstream in(name.c_str());
+		if (in.fail()) {
+			cerr << "bogglebatch: couldn't open " << name << endl;
+			return 1;
+		}
+		SolveStream(in, name, jobs, pool, json);
+	}
+	if (catalog != NULL) {
+		catalog->close();
+		delete catalog;
+	}
+	return 0;
+}
@@ -0,0 +1,508 @@
+/*
+ * File: bogglebench.cpp
+ * ---------------------
+ * A command-line tool that times the lexicon and the solver, so changes
+ * to either can be measured. It runs a fixed list of benchmarks and
+ * writes one JSON object per line for each, giving its name, the number
+ * of operations timed, the total time and the time per operation:
+ *
+ *	{"bench":"solve.4x4","ops":4096,"seconds":0.201,"nsPerOp":49072}
+ *
+ * Usage: bogglebench [-lexicon file] [-seed n] [-boards n] [-time seconds] [name ...]
+ *
+ * The benchmarks are:
+ *
+ *	load.text, load.dawg, load.native	reading the lexicon as a word list,
+ *					as a DAWG file and as a native file (which is mapped)
+ *	containsWord.real, .random	looking up words of the lexicon, and
+ *					random strings of letters
+ *	containsPrefix.real, .random	the same for prefixes
+ *	enumerate.mapAll, .visit,	every word of the lexicon, with mapAll,
+ *	  .iterator			visitWords and an Iterator
+ *	solve.4x4, solve.5x5		SolveBoard on random boards
+ *	solveParallel.4x4, .5x5		SolveBoardParallel, as the computer's turn runs it
+ *	findPath.real			FindWordPath on words that are on the board
+ *	findPath.repeated		FindWordPath on random A and E strings, on
+ *					5x5 boards rolled from the AAEEEE cube
+ *	findPath.perBoard		lexicon words checked on 64 4x4 boards, one
+ *					board at a time with FindWordPath
+ *	findPath.sliced			the same checks with BoardSlices, all 64
+ *					boards at once
+ *	engine.boardFirst.repeated,	ScoreBoard with each engine on the A
+ *	  .dictionaryFirst.repeated	and E boards of findPath.repeated
+ *	engine.boardFirst.themed,	ScoreBoard with each engine on random
+ *	  .dictionaryFirst.themed	5x5 boards, against NUM_THEMED_WORDS
+ *					words of the lexicon
+ *	engine.auto.repeated, .themed	the same with the engine ChooseSolveEngine
+ *					picks
+ *	wordsSeen.set, .hashSet		the words of each 4x4 board looked up and
+ *					added, as the game keeps the words found, in
+ *					a Set<string> and a WordHashSet
+ *
+ * Naming benchmarks on the command line runs only those; a name ending
+ * in a dot, like solve., runs every benchmark starting with it. Each
+ * benchmark is run over and over until it has taken at least the
+ * given time (half a second by default). Boards are shaken from the
+ * real cube sets and the random strings are drawn with the random
+ * number generator seeded from -seed, so the same arguments time the
+ * same work from run to run. The text and native files the load
+ * benchmarks read are written to temporary files from the lexicon.
+ */
+
+#include "genlib.h"
+#include "consoletool.h"
+#include "strutils.h"
+#include "board.h"
+#include "lexicon.h"
+#include "bogglesolver.h"
+#include "boardslices.h"
+#include "threadpool.h"
+#include "wordhashset.h"
+#include "walltime.h"
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <cstdlib>
+#include <cstdio>
+#include <unistd.h>		// for mkstemp, close, unlink
+
+
+/* Constants
+ * ---------
+ */
+
+const int NUM_LOOKUPS = 100000;		// strings in each of the lookup sets
+const int NUM_REPEATED_WORDS = 1000;	// strings for findPath.repeated
+const int NUM_GRADED_WORDS = 1000;		// words, of the real lookups, for findPath.perBoard and .sliced
+const int NUM_THEMED_WORDS = 25;		// words in the lexicon for the engine.*.themed benchmarks
+
+
+/* Struct: benchDataT
+ * ------------------
+ * Everything the benchmarks work from, made once before any of them run.
+ */
+
+struct benchDataT {
+	string dawgFile, textFile, nativeFile;
+	Lexicon lex, themedLex;
+	std::vector<string> realWords, randomWords;
+	std::vector<string> realPrefixes, randomPrefixes;
+	std::vector<StandardBoard> standardBoards;
+	std::vector<BigBoard> bigBoards, repeatedBoards;
+	std::vector<string> foundWords, repeatedWords;
+	std::vector<int> foundBoards;			// the standard board each of foundWords is on
+	BoardSlices<StandardBoard> slicedBoards;	// the first standard boards, up to 64
+	ThreadPool *pool;
+	int sink;								// results go here so nothing timed can be skipped
+};
+
+
+/*
+ * Type: benchFnT
+ * --------------
+ * A benchmark runs its operation once over its whole data set and
+ * returns the number of operations it did.
+ */
+typedef int (*benchFnT)(benchDataT & data);
+
+
+/* Benchmarks
+ * ----------
+ */
+
+static int LoadText(benchDataT & data)
+{
+	Lexicon lex(data.textFile);
+	data.sink += lex.size();
+	return 1;
+}
+
+static int LoadDawg(benchDataT & data)
+{
+	Lexicon lex(data.dawgFile);
+	data.sink += lex.size();
+	return 1;
+}
+
+static int LoadNative(benchDataT & data)
+{
+	Lexicon lex(data.nativeFile);
+	data.sink += lex.size();
+	return 1;
+}
+
+static int LookUpWords(const Lexicon & lex, const std::vector<string> & words, benchDataT & data)
+{
+	for (int i = 0; i < words.size(); i++) {
+		if (lex.containsWord(words[i])) data.sink++;
+	}
+	return words.size();
+}
+
+static int LookUpPrefixes(const Lexicon & lex, const std::vector<string> & prefixes, benchDataT & data)
+{
+	for (int i = 0; i < prefixes.size(); i++) {
+		if (lex.containsPrefix(prefixes[i])) data.sink++;
+	}
+	return prefixes.size();
+}
+
+static int ContainsWordReal(benchDataT & data) { return LookUpWords(data.lex, data.realWords, data); }
+static int ContainsWordRandom(benchDataT & data) { return LookUpWords(data.lex, data.randomWords, data); }
+static int ContainsPrefixReal(benchDataT & data) { return LookUpPrefixes(data.lex, data.realPrefixes, data); }
+static int ContainsPrefixRandom(benchDataT & data) { return LookUpPrefixes(data.lex, data.randomPrefixes, data); }
+
+static void AddLength(string word, int & total)
+{
+	total += word.length();
+}
+
+// Adds up the word lengths for visitWords.
+struct lengthVisitorT {
+	int total;
+	void operator()(const string & word) { total += word.length(); }
+};
+
+static int EnumerateMapAll(benchDataT & data)
+{
+	data.lex.mapAll(AddLength, data.sink);
+	return data.lex.size();
+}
+
+static int EnumerateVisit(benchDataT & data)
+{
+	lengthVisitorT visitor = { 0 };
+	data.sink += data.lex.visitWords(visitor).total;
+	return data.lex.size();
+}
+
+static int EnumerateIterator(benchDataT & data)
+{
+	Lexicon::Iterator itr = data.lex.iterator();
+	while (itr.hasNext())
+		data.sink += itr.next().length();
+	return data.lex.size();
+}
+
+template <typename BoardType>
+  static int SolveBoards(const std::vector<BoardType> & boards, benchDataT & data, bool parallel)
+{
+	for (int i = 0; i < boards.size(); i++) {
+		Set<string> wordsSeen;
+		Vector<string> found;
+		if (parallel) SolveBoardParallel(boards[i], data.lex, wordsSeen, found, *data.pool);
+		else SolveBoard(boards[i], data.lex, wordsSeen, found);
+		data.sink += found.size();
+	}
+	return boards.size();
+}
+
+static int Solve4x4(benchDataT & data) { return SolveBoards(data.standardBoards, data, false); }
+static int Solve5x5(benchDataT & data) { return SolveBoards(data.bigBoards, data, false); }
+static int SolveParallel4x4(benchDataT & data) { return SolveBoards(data.standardBoards, data, true); }
+static int SolveParallel5x5(benchDataT & data) { return SolveBoards(data.bigBoards, data, true); }
+
+template <typename BoardType>
+  static int ScoreBoards(const std::vector<BoardType> & boards, const Lexicon & lex, solveEngineT engine,
+						 benchDataT & data)
+{
+	WordIndexSet words;
+	for (int i = 0; i < boards.size(); i++)
+		data.sink += ScoreBoard(boards[i], lex, words, engine);
+	return boards.size();
+}
+
+static int BoardFirstRepeated(benchDataT & data)
+{
+	return ScoreBoards(data.repeatedBoards, data.lex, BoardFirstEngine, data);
+}
+
+static int DictionaryFirstRepeated(benchDataT & data)
+{
+	return ScoreBoards(data.repeatedBoards, data.lex, DictionaryFirstEngine, data);
+}
+
+static int AutoRepeated(benchDataT & data) { return ScoreBoards(data.repeatedBoards, data.lex, AutoEngine, data); }
+
+static int BoardFirstThemed(benchDataT & data)
+{
+	return ScoreBoards(data.bigBoards, data.themedLex, BoardFirstEngine, data);
+}
+
+static int DictionaryFirstThemed(benchDataT & data)
+{
+	return ScoreBoards(data.bigBoards, data.themedLex, DictionaryFirstEngine, data);
+}
+
+static int AutoThemed(benchDataT & data) { return ScoreBoards(data.bigBoards, data.themedLex, AutoEngine, data); }
+
+static int FindPathReal(benchDataT & data)
+{
+	int path[StandardBoard::NUM_CELLS];
+	for (int i = 0; i < data.foundWords.size(); i++) {
+		if (FindWordPath(data.standardBoards[data.foundBoards[i]], data.foundWords[i], path)) data.sink++;
+	}
+	return data.foundWords.size();
+}
+
+static int FindPathRepeated(benchDataT & data)
+{
+	int path[BigBoard::NUM_CELLS];
+	for (int i = 0; i < data.repeatedWords.size(); i++) {
+		if (FindWordPath(data.repeatedBoards[i % data.repeatedBoards.size()], data.repeatedWords[i], path))
+			data.sink++;
+	}
+	return data.repeatedWords.size();
+}
+
+// Looks up and adds the words of each standard board in a set of its
+// own, checking each word twice as the game does when the player has
+// found it and the computer's turn passes it over.
+template <typename SetType>
+  static int SeeWords(benchDataT & data)
+{
+	int start = 0;
+	while (start < data.foundWords.size()) {
+		int end = start;
+		while (end < data.foundWords.size() && data.foundBoards[end] == data.foundBoards[start])
+			end++;
+		SetType wordsSeen;
+		for (int i = start; i < end; i++) {
+			if (!wordsSeen.contains(data.foundWords[i])) wordsSeen.add(data.foundWords[i]);
+		}
+		for (int i = start; i < end; i++) {
+			if (wordsSeen.contains(data.foundWords[i])) data.sink++;
+		}
+		start = end;
+	}
+	return data.foundWords.size();
+}
+
+static int SeenSet(benchDataT & data) { return SeeWords< Set<string> >(data); }
+static int SeenHashSet(benchDataT & data) { return SeeWords<WordHashSet>(data); }
+
+static int FindPathPerBoard(benchDataT & data)
+{
+	int path[StandardBoard::NUM_CELLS];
+	int numWords = NUM_GRADED_WORDS;		// realWords has NUM_LOOKUPS of them
+	for (int i = 0; i < numWords; i++) {
+		for (int j = 0; j < data.slicedBoards.size(); j++) {
+			if (FindWordPath(data.standardBoards[j], data.realWords[i], path)) data.sink++;
+		}
+	}
+	return numWords * data.slicedBoards.size();
+}
+
+static int FindPathSliced(benchDataT & data)
+{
+	int numWords = NUM_GRADED_WORDS;		// realWords has NUM_LOOKUPS of them
+	for (int i = 0; i < numWords; i++) {
+		if (data.slicedBoards.boardsWithWord(data.realWords[i]) != 0) data.sink++;
+	}
+	return numWords * data.slicedBoards.size();
+}
+
+
+/* Struct: benchT
+ * --------------
+ * The table of benchmarks, in the order they are run.
+ */
+
+struct benchT {
+	const char *name;
+	benchFnT fn;
+};
+
+static const benchT Benchmarks[] = {
+	{ "load.text", LoadText },
+	{ "load.dawg", LoadDawg },
+	{ "load.native", LoadNative },
+	{ "containsWord.real", ContainsWordReal },
+	{ "containsWord.random", ContainsWordRandom },
+	{ "containsPrefix.real", ContainsPrefixReal },
+	{ "containsPrefix.random", ContainsPrefixRandom },
+	{ "enumerate.mapAll", EnumerateMapAll },
+	{ "enumerate.visit", EnumerateVisit },
+	{ "enumerate.iterator", EnumerateIterator },
+	{ "solve.4x4", Solve4x4 },
+	{ "solve.5x5", Solve5x5 },
+	{ "solveParallel.4x4", SolveParallel4x4 },
+	{ "solveParallel.5x5", SolveParallel5x5 },
+	{ "findPath.real", FindPathReal },
+	{ "findPath.repeated", FindPathRepeated },
+	{ "findPath.perBoard", FindPathPerBoard },
+	{ "findPath.sliced", FindPathSliced },
+	{ "engine.boardFirst.repeated", BoardFirstRepeated },
+	{ "engine.dictionaryFirst.repeated", DictionaryFirstRepeated },
+	{ "engine.auto.repeated", AutoRepeated },
+	{ "engine.boardFirst.themed", BoardFirstThemed },
+	{ "engine.dictionaryFirst.themed", DictionaryFirstThemed },
+	{ "engine.auto.themed", AutoThemed },
+	{ "wordsSeen.set", SeenSet },
+	{ "wordsSeen.hashSet", SeenHashSet },
+};
+
+const int NUM_BENCHMARKS = sizeof(Benchmarks) / sizeof(Benchmarks[0]);
+
+
+/* Setup
+ * -----
+ */
+
+static string RandomLetters(int minLength, int maxLength, const string & alphabet)
+{
+	int length = RandomInteger(minLength, maxLength);
+	string s;
+	for (int i = 0; i < length; i++) {
+		s += alphabet[RandomInteger(0, alphabet.length() - 1)];
+	}
+	return s;
+}
+
+static void CollectWord(string word, std::vector<string> & words)
+{
+	words.push_back(word);
+}
+
+static void WriteWord(string word, ofstream & out)
+{
+	out << word << '\n';
+}
+
+// Returns the name of a new, empty temporary file.
+static string MakeTempFile()
+{
+	char name[] = "/tmp/bogglebenchXXXXXX";
+	int fd = mkstemp(name);
+	if (fd == -1) Error("bogglebench couldn't make a temporary file.");
+	close(fd);
+	return name;
+}
+
+static void SetUp(benchDataT & data, int numBoards)
+{
+	std::vector<string> all;
+	data.lex.mapAll(CollectWord, all);
+	if (all.empty()) Error("bogglebench needs a lexicon with some words in it.");
+
+	data.textFile = MakeTempFile();
+	ofstream text(data.textFile.c_str());
+	data.lex.mapAll(WriteWord, text);
+	text.close();
+	data.nativeFile = MakeTempFile();
+	data.lex.writeNativeFile(data.nativeFile);
+
+	string alphabet = "abcdefghijklmnopqrstuvwxyz";
+	for (int i = 0; i < NUM_LOOKUPS; i++) {
+		string word = all[RandomInteger(0, all.size() - 1)];
+		data.realWords.push_back(word);
+		data.realPrefixes.push_back(word.substr(0, RandomInteger(1, word.length())));
+		data.randomWords.push_back(RandomLetters(4, 10, alphabet));
+		data.randomPrefixes.push_back(RandomLetters(1, 6, alphabet));
+	}
+	for (int i = 0; i < NUM_THEMED_WORDS; i++) {
+		data.themedLex.add(all[RandomInteger(0, all.size() - 1)]);
+	}
+
+	for (int i = 0; i < numBoards; i++) {
+		StandardBoard standard;
+		standard.shake();
+		data.standardBoards.push_back(standard);
+		BigBoard big;
+		big.shake();
+		data.bigBoards.push_back(big);
+		BigBoard repeated;
+		for (int cell = 0; cell < BigBoard::NUM_CELLS; cell++) {
+			repeated.setLetterAt(cell, RandomChance(2.0 / 6) ? 'A' : 'E');
+		}
+		data.repeatedBoards.push_back(repeated);
+	}
+	for (int i = 0; i < data.standardBoards.size() && i < BoardSlices<StandardBoard>::MAX_BOARDS; i++) {
+		data.slicedBoards.add(data.standardBoards[i]);
+	}
+	for (int i = 0; i < data.standardBoards.size(); i++) {
+		Set<string> wordsSeen;
+		Vector<string> found;
+		SolveBoard(data.standardBoards[i], data.lex, wordsSeen, found);
+		for (int j = 0; j < found.size(); j++) {
+			data.foundWords.push_back(found[j]);
+			data.foundBoards.push_back(i);
+		}
+	}
+	for (int i = 0; i < NUM_REPEATED_WORDS; i++) {
+		data.repeatedWords.push_back(RandomLetters(MIN_WORD_LENGTH, 12, "AE"));
+	}
+	data.sink = 0;
+}
+
+// Reports whether the benchmark was asked for on the command line.
+static bool Selected(string name, Vector<string> & wanted)
+{
+	if (wanted.isEmpty()) return true;
+	for (int i = 0; i < wanted.size(); i++) {
+		string w = wanted[i];
+		if (w == name) return true;
+		if (!w.empty() && w[w.length() - 1] == '.' && name.compare(0, w.length(), w) == 0) return true;
+	}
+	return false;
+}
+
+static void RunBenchmark(const benchT & bench, benchDataT & data, double minSeconds)
+{
+	long long ops = 0;
+	double start = CurrentTime(), elapsed = 0;
+	do {
+		ops += bench.fn(data);
+		elapsed = CurrentTime() - start;
+	} while (elapsed < minSeconds);
+	char line[200];
+	sprintf(line, "{\"bench\":\"%s\",\"ops\":%lld,\"seconds\":%.3f,\"nsPerOp\":%.0f}",
+			bench.name, ops, elapsed, (ops > 0) ? elapsed * 1e9 / ops : 0.0);
+	cout << line << endl;
+}
+
+static void Usage()
+{
+	cerr << "Usage: bogglebench [-lexicon file] [-seed n] [-boards n] [-time seconds] [name ...]" << endl;
+	exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+	benchDataT data;
+	data.dawgFile = "lexicon.dat";
+	int seed = 1, numBoards = 200;
+	double minSeconds = 0.5;
+	int arg = 1;
+	for (; arg < argc && argv[arg][0] == '-'; arg++) {
+		string flag = argv[arg];
+		if (flag == "-lexicon" && arg + 1 < argc) {
+			data.dawgFile = argv[++arg];
+		} else if (flag == "-seed" && arg + 1 < argc) {
+			seed = atoi(argv[++arg]);
+		} else if (flag == "-boards" && arg + 1 < argc) {
+			numBoards = atoi(argv[++arg]);
+		} else if (flag == "-time" && arg + 1 < argc) {
+			minSeconds = atof(argv[++arg]);
+		} else {
+			Usage();
+		}
+	}
+	if (numBoards <= 0) Usage();
+	Vector<string> wanted;
+	for (; arg < argc; arg++) {
+		wanted.add(argv[arg]);
+	}
+
+	srand(seed);		// RandomInteger and Board::shake draw from rand
+	data.lex.addWordsFromFile(data.dawgFile);
+	ThreadPool pool;
+	data.pool = &pool;
+	SetUp(data, numBoards);
+	for (int i = 0; i < NUM_BENCHMARKS; i++) {
+		if (Selected(Benchmarks[i].name, wanted)) RunBenchmark(Benchmarks[i], data, minSeconds);
+	}
+	unlink(data.textFile.c_str());
+	unlink(data.nativeFile.c_str());
+	return (data.sink == -1);		// never true; keeps the results live
+}
@@ -0,0 +1,97 @@
+/*
+ * File: bogglecatalog.cpp
+ * -----------------------
+ * A command-line tool that reads a catalog of solved boards written by
+ * bogglebatch -catalog (see solutioncatalog.h) and writes each record as
+ * bogglebatch writes a board: the letters, the total score, the number
+ * of words and the words, separated by tabs, with the words in the
+ * lexicon's order,
+ *
+ *	ABCDEFGHIJKLMNOP	10	8	fink fino glop jink knife knop mink plonk
+ *
+ * With -paths, each word is followed by the cells of its path, numbered
+ * from 0 in row-major order, as in fink:5,8,13,10; records without paths
+ * just give the words. With -summary, only the number of records, boards
+ * and words is written, which times how fast the catalog can be read.
+ *
+ * Usage: bogglecatalog [-paths | -summary] [-lexicon file] catalog
+ *
+ * The word indexes are turned back into words with the lexicon, which
+ * must be the one the catalog was written with.
+ */
+
+#include "genlib.h"
+#include "consoletool.h"
+#include "strutils.h"
+#include "lexicon.h"
+#include "bogglesolver.h"
+#include "solutioncatalog.h"
+#include <iostream>
+#include <cstdlib>
+
+
+static void WriteRecord(const SolutionCatalog::Record & record, const Lexicon & lex, bool paths)
+{
+	string words;
+	int score = 0;
+	SolutionCatalog::WordCursor cursor = record.words();
+	while (cursor.hasNext()) {
+		string word = lex.wordAt(cursor.next());
+		score += ScoreForWord(word);
+		if (!words.empty()) words += ' ';
+		words += word;
+		if (!paths) continue;
+		for (int i = 0; i < cursor.pathLength(); i++) {
+			words += (i == 0) ? ':' : ',';
+			words += IntegerToString(cursor.pathCell(i));
+		}
+	}
+	cout << record.letters() << '\t' << score << '\t' << record.numWords() << '\t' << words << '\n';
+}
+
+static void Usage()
+{
+	cerr << "Usage: bogglecatalog [-paths | -summary] [-lexicon file] catalog" << endl;
+	exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+	bool paths = false, summary = false;
+	string lexiconFile = "lexicon.dat";
+	int arg = 1;
+	for (; arg < argc && argv[arg][0] == '-'; arg++) {
+		string flag = argv[arg];
+		if (flag == "-paths") {
+			paths = true;
+		} else if (flag == "-summary") {
+			summary = true;
+		} else if (flag == "-lexicon" && arg + 1 < argc) {
+			lexiconFile = argv[++arg];
+		} else {
+			Usage();
+		}
+	}
+	if (arg != argc - 1 || (paths && summary)) Usage();
+	SolutionCatalog catalog(argv[arg]);
+	if (summary) {
+		long long numBoards = 0, numWords = 0;
+		for (SolutionCatalog::Record record = catalog.firstRecord(); record.isValid();
+			 record = catalog.nextRecord(record)) {
+			SolutionCatalog::WordCursor cursor = record.words();
+			while (cursor.hasNext()) {
+				cursor.next();
+				numWords++;
+			}
+			numBoards++;
+		}
+		cout << "records\t" << catalog.size() << "\nboards\t" << numBoards << "\nwords\t" << numWords << '\n';
+		return 0;
+	}
+	Lexicon lex(lexiconFile);
+	if (!catalog.matchesLexicon(lex))
+		Error(string(argv[arg]) + " was written with some other lexicon than " + lexiconFile);
+	for (SolutionCatalog::Record record = catalog.firstRecord(); record.isValid(); record = catalog.nextRecord(record))
+		WriteRecord(record, lex, paths);
+	return 0;
+}
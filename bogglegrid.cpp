@@ -0,0 +1,154 @@
+/*
+ * File: bogglegrid.cpp
+ * --------------------
+ * A command-line tool that finds every word on a grid of letters of any
+ * size, by the rules of the game, for word searches far bigger than a
+ * Boggle board. The grid is read from a file, or the standard input,
+ * one row per line, or rolled at random from the Big Boggle cubes. The
+ * words are written one per line, each once, as the tiles they start in
+ * are solved, and a summary goes to the standard error:
+ *
+ *	bogglegrid: 1000x1000 grid, 256 tiles, 103944 words, 485031 points
+ *
+ * Usage: bogglegrid [-random rows cols] [-seed n] [-tile n] [-threads n]
+ *                   [-count] [-lexicon file] [file]
+ *
+ * Every row of a grid read in must have the same number of letters;
+ * spaces and tabs are ignored. -tile sets the side of the square tiles
+ * the grid is solved in (see SolveLargeBoard), and -count leaves out
+ * the words and writes just the summary. Nothing but the lexicon's word
+ * indexes is kept for the whole grid, so the memory needed grows with
+ * the size of the lexicon rather than the number of words found.
+ */
+
+#include "genlib.h"
+#include "consoletool.h"
+#include "largeboard.h"
+#include "lexicon.h"
+#include "bogglesolver.h"
+#include "threadpool.h"
+#include "fastrandom.h"
+#include "wordindexset.h"
+#include "strutils.h"
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <cstdlib>
+
+
+/* Struct: totalsT
+ * ---------------
+ * What the tiles have turned up so far.
+ */
+
+struct totalsT {
+	const Lexicon *lex;
+	bool writeWords;
+	int numTiles;
+	int score;
+	WordIndexSet found;			// the words written so far
+};
+
+
+// Writes the words of a tile that no earlier tile had. SolveLargeBoard
+// never calls this from two threads at once.
+static void RecordTile(const tileWordsT & tile, void *data)
+{
+	totalsT & totals = *(totalsT *)data;
+	totals.numTiles++;
+	for (int i = 0; i < tile.words.size(); i++) {
+		int index = tile.words[i];
+		if (!totals.found.add(index)) continue;
+		string word = totals.lex->wordAt(index);
+		totals.score += ScoreForLength(word.length());
+		if (totals.writeWords) cout << word << '\n';
+	}
+}
+
+// Reads a grid, one row per line, leaving out blank lines.
+static LargeBoard *ReadGrid(istream & in)
+{
+	std::vector<string> rows;
+	string line;
+	while (getline(in, line)) {
+		string row;
+		for (int i = 0; i < line.length(); i++) {
+			if (line[i] != ' ' && line[i] != '\t' && line[i] != '\r') row += line[i];
+		}
+		if (row.empty()) continue;
+		if (!rows.empty() && row.length() != rows[0].length())
+			Error("Row " + IntegerToString(rows.size() + 1) + " of the grid isn't as long as the first");
+		rows.push_back(row);
+	}
+	if (rows.empty()) Error("The grid is empty");
+	LargeBoard *board = new LargeBoard(rows.size(), rows[0].length());
+	for (int row = 0; row < rows.size(); row++) {
+		for (int col = 0; col < rows[row].length(); col++)
+			board->setLetterAt(board->cellAt(row, col), rows[row][col]);
+	}
+	return board;
+}
+
+static void Usage()
+{
+	cerr << "Usage: bogglegrid [-random rows cols] [-seed n] [-tile n] [-threads n]" << endl
+		 << "                  [-count] [-lexicon file] [file]" << endl;
+	exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+	int randomRows = 0, randomCols = 0, tileSize = 64, numThreads = 0;
+	unsigned long long seed = 1;
+	bool countOnly = false;
+	string lexiconFile = "lexicon.dat", gridFile;
+	for (int arg = 1; arg < argc; arg++) {
+		string flag = argv[arg];
+		if (flag == "-random" && arg + 2 < argc) {
+			randomRows = atoi(argv[++arg]);
+			randomCols = atoi(argv[++arg]);
+			if (randomRows <= 0 || randomCols <= 0) Usage();
+		} else if (flag == "-seed" && arg + 1 < argc) {
+			seed = strtoull(argv[++arg], NULL, 10);
+		} else if (flag == "-tile" && arg + 1 < argc) {
+			tileSize = atoi(argv[++arg]);
+		} else if (flag == "-threads" && arg + 1 < argc) {
+			numThreads = atoi(argv[++arg]);
+		} else if (flag == "-count") {
+			countOnly = true;
+		} else if (flag == "-lexicon" && arg + 1 < argc) {
+			lexiconFile = argv[++arg];
+		} else if (flag[0] != '-' && gridFile.empty()) {
+			gridFile = flag;
+		} else {
+			Usage();
+		}
+	}
+	if (tileSize <= 0 || (randomRows > 0 && !gridFile.empty())) Usage();
+
+	LargeBoard *board;
+	if (randomRows > 0) {
+		board = new LargeBoard(randomRows, randomCols);
+		FastRandom rng(seed);
+		board->roll(rng);
+	} else if (gridFile.empty()) {
+		board = ReadGrid(cin);
+	} else {
+		ifstream in(gridFile.c_str());
+		if (in.fail()) Error("Couldn't open " + gridFile);
+		board = ReadGrid(in);
+	}
+
+	Lexicon lex(lexiconFile);
+	ThreadPool pool(numThreads);
+	totalsT totals;
+	totals.lex = &lex;
+	totals.writeWords = !countOnly;
+	totals.numTiles = totals.score = 0;
+	SolveLargeBoard(*board, lex, pool, RecordTile, &totals, tileSize);
+	cout.flush();
+	cerr << "bogglegrid: " << board->numRows() << "x" << board->numCols() << " grid, " << totals.numTiles
+		 << " tiles, " << totals.found.size() << " words, " << totals.score << " points" << endl;
+	delete board;
+	return 0;
+}
@@ -0,0 +1,246 @@
+/*
+ * File: boggleoptimizer.cpp
+ * -------------------------
+ * A command-line tool that searches for Boggle boards with high scores,
+ * for when a hard puzzle is wanted on purpose. Each run starts from a
+ * shaken board, as the game deals one, and improves it by simulated
+ * annealing: at every step it either swaps two cubes or turns one cube
+ * to another of its faces, so every board it considers could be dealt
+ * from the real set of cubes. A move that scores at least as well is
+ * always kept; a worse one is kept with a chance that shrinks as the
+ * temperature is lowered from -temp's first value to its second, which
+ * lets a run climb out of local peaks early on and settle at the end.
+ * Since a move changes only one or two cubes, each run keeps its words
+ * in an IncrementalSolver, which re-searches just the paths through the
+ * cubes that moved, and takes a rejected move back without searching.
+ *
+ * Usage: boggleoptimizer [-big] [-words] [-steps n] [-runs n] [-threads n]
+ *                        [-seed n] [-temp start end] [-lexicon file]
+ *
+ * -big optimizes 5x5 Big Boggle boards rather than 4x4 ones, and -words
+ * maximizes the number of words rather than the total score. The runs
+ * are independent restarts, spread over a thread pool, each with its own
+ * random numbers drawn from the seed and its run number, so the results
+ * don't depend on the number of threads. Each run's best board is
+ * written on its own line, in run order, in the same tab-separated form
+ * as bogglebatch without the word list, and the best of them is written
+ * again on standard error at the end:
+ *
+ *	SINDLATEPERSSIDO	2424	940
+ */
+
+#include "genlib.h"
+#include "consoletool.h"
+#include "board.h"
+#include "lexicon.h"
+#include "bogglesolver.h"
+#include "incrementalsolver.h"
+#include "threadpool.h"
+#include "fastrandom.h"
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+
+
+/* Struct: settingsT
+ * -----------------
+ * The options shared by every run.
+ */
+
+struct settingsT {
+	const Lexicon *lex;
+	const Lexicon *reversed;		// lex's prefixes spelled backward, for the solvers
+	bool countWords;				// maximize word count instead of score
+	int numSteps;
+	double startTemp, endTemp;
+	unsigned long long seed;
+};
+
+
+/* Struct: runT
+ * ------------
+ * One restart of the search, and the best board it found.
+ */
+
+struct runT {
+	const settingsT *settings;
+	int index;
+	string bestLetters;
+	int bestScore, bestWords;
+};
+
+
+/* Class: Roll
+ * -----------
+ * A board along with which cube is in each cell and which face of it is
+ * up, so that moves can only make boards the cubes could show.
+ */
+
+template <typename BoardType>
+  class Roll {
+  public:
+	BoardType board;
+	int cubeAt[BoardType::NUM_CELLS];
+	int faceAt[BoardType::NUM_CELLS];
+
+	// Puts the cubes in a random order with random faces up.
+	void shake(FastRandom & rng)
+	{
+		for (int cell = 0; cell < BoardType::NUM_CELLS; cell++) {
+			cubeAt[cell] = cell;
+		}
+		for (int cell = BoardType::NUM_CELLS - 1; cell > 0; cell--) {
+			int other = rng.nextInt(0, cell);
+			int cube = cubeAt[cell];
+			cubeAt[cell] = cubeAt[other];
+			cubeAt[other] = cube;
+		}
+		for (int cell = 0; cell < BoardType::NUM_CELLS; cell++) {
+			setFace(cell, rng.nextInt(0, BoardType::numFaces() - 1));
+		}
+	}
+
+	void setFace(int cell, int face)
+	{
+		faceAt[cell] = face;
+		board.setLetterAt(cell, BoardType::cubeFace(cubeAt[cell], face));
+	}
+
+	void swapCubes(int a, int b)
+	{
+		int cube = cubeAt[a], face = faceAt[a];
+		cubeAt[a] = cubeAt[b];
+		cubeAt[b] = cube;
+		setFace(a, faceAt[b]);
+		setFace(b, face);
+	}
+};
+
+
+// Returns the value being maximized for the solver's board.
+template <typename BoardType>
+  static int Evaluate(IncrementalSolver<BoardType> & solver, const settingsT & settings)
+{
+	return settings.countWords ? solver.numWords() : solver.score();
+}
+
+template <typename BoardType>
+  static void Anneal(runT & run)
+{
+	const settingsT & settings = *run.settings;
+	FastRandom rng(settings.seed * 1000003 + run.index);
+	IncrementalSolver<BoardType> solver(*settings.lex, *settings.reversed);
+	Roll<BoardType> current;
+	current.shake(rng);
+	solver.update(current.board);
+	int value = Evaluate(solver, settings);
+	run.bestLetters = current.board.toString();
+	run.bestScore = solver.score();
+	run.bestWords = solver.numWords();
+	int bestValue = value;
+
+	double cooling = (settings.numSteps > 1) ? pow(settings.endTemp / settings.startTemp, 1.0 / (settings.numSteps - 1)) : 1;
+	double temp = settings.startTemp;
+	for (int step = 0; step < settings.numSteps; step++, temp *= cooling) {
+		Roll<BoardType> next = current;
+		if (rng.nextInt(0, 1) == 0) {
+			int a = rng.nextInt(0, BoardType::NUM_CELLS - 1);
+			int b = rng.nextInt(0, BoardType::NUM_CELLS - 2);
+			if (b >= a) b++;
+			next.swapCubes(a, b);
+		} else {
+			int cell = rng.nextInt(0, BoardType::NUM_CELLS - 1);
+			int face = rng.nextInt(0, BoardType::numFaces() - 2);
+			if (face >= next.faceAt[cell]) face++;
+			next.setFace(cell, face);
+		}
+		solver.update(next.board);
+		int nextValue = Evaluate(solver, settings);
+		if (nextValue >= value || rng.nextReal() < exp((nextValue - value) / temp)) {
+			current = next;
+			value = nextValue;
+			if (value > bestValue) {
+				bestValue = value;
+				run.bestLetters = current.board.toString();
+				run.bestScore = solver.score();
+				run.bestWords = solver.numWords();
+			}
+		} else {
+			solver.undo();
+		}
+	}
+}
+
+static void RunStandard(void *data, int worker) { Anneal<StandardBoard>(*(runT *)data); }
+static void RunBig(void *data, int worker) { Anneal<BigBoard>(*(runT *)data); }
+
+static void Usage()
+{
+	cerr << "Usage: boggleoptimizer [-big] [-words] [-steps n] [-runs n] [-threads n]" << endl
+		 << "                       [-seed n] [-temp start end] [-lexicon file]" << endl;
+	exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+	settingsT settings;
+	settings.countWords = false;
+	settings.numSteps = 20000;
+	settings.startTemp = 50;
+	settings.endTemp = 0.5;
+	settings.seed = 1;
+	bool big = false;
+	int numRuns = 8, numThreads = 0;
+	string lexiconFile = "lexicon.dat";
+	for (int arg = 1; arg < argc; arg++) {
+		string flag = argv[arg];
+		if (flag == "-big") {
+			big = true;
+		} else if (flag == "-words") {
+			settings.countWords = true;
+		} else if (flag == "-steps" && arg + 1 < argc) {
+			settings.numSteps = atoi(argv[++arg]);
+		} else if (flag == "-runs" && arg + 1 < argc) {
+			numRuns = atoi(argv[++arg]);
+		} else if (flag == "-threads" && arg + 1 < argc) {
+			numThreads = atoi(argv[++arg]);
+		} else if (flag == "-seed" && arg + 1 < argc) {
+			settings.seed = strtoull(argv[++arg], NULL, 10);
+		} else if (flag == "-temp" && arg + 2 < argc) {
+			settings.startTemp = atof(argv[++arg]);
+			settings.endTemp = atof(argv[++arg]);
+		} else if (flag == "-lexicon" && arg + 1 < argc) {
+			lexiconFile = argv[++arg];
+		} else {
+			Usage();
+		}
+	}
+	if (numRuns <= 0 || settings.numSteps < 0 || settings.startTemp <= 0 || settings.endTemp <= 0) Usage();
+
+	Lexicon lex(lexiconFile), reversed;
+	lex.extractReversedPrefixes(reversed);
+	settings.lex = &lex;
+	settings.reversed = &reversed;
+	Vector<runT> runs;
+	for (int i = 0; i < numRuns; i++) {
+		runT run;
+		run.settings = &settings;
+		run.index = i;
+		runs.add(run);
+	}
+	ThreadPool pool(numThreads);
+	for (int i = 0; i < runs.size(); i++) {
+		pool.submit(big ? RunBig : RunStandard, &runs[i]);
+	}
+	pool.wait();
+
+	int best = 0;
+	for (int i = 0; i < runs.size(); i++) {
+		cout << runs[i].bestLetters << '\t' << runs[i].bestScore << '\t' << runs[i].bestWords << endl;
+		int value = settings.countWords ? runs[i].bestWords : runs[i].bestScore;
+		int bestValue = settings.countWords ? runs[best].bestWords : runs[best].bestScore;
+		if (value > bestValue) best = i;
+	}
+	cerr << "best: " << runs[best].bestLetters << '\t' << runs[best].bestScore << '\t' << runs[best].bestWords << endl;
+	return 0;
+}
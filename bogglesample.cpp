@@ -0,0 +1,282 @@
+/*
+ * File: bogglesample.cpp
+ * ----------------------
+ * A command-line tool that shakes a great many random boards from the
+ * real cubes and reports how their scores and words are spread, for
+ * questions like how good a typical board is or how rare a 100-point
+ * board is. It writes the number of boards, then a percentile table
+ * with a line each for the score, the number of words and the length of
+ * the longest word, then the words that turn up most often, with the
+ * number and fraction of boards they were on, all tab-separated:
+ *
+ *	boards	1000000
+ *	measure	mean	min	1%	5%	10%	25%	50%	75%	90%	95%	99%	max
+ *	score	...
+ *	words	...
+ *	longest	...
+ *	word	boards	fraction
+ *	tees	127905	0.1279
+ *
+ * Usage: bogglesample [-big] [-boards n] [-seed n] [-threads n] [-top n]
+ *                     [-histograms] [-lexicon file]
+ *
+ * -big samples 5x5 Big Boggle boards rather than 4x4 ones, -boards sets
+ * how many (100000 by default), and -top how many of the most common
+ * words are listed (20 by default). -histograms adds a line for every
+ * value each measure took, giving the measure, the value and the number
+ * of boards. The boards are dealt in numbered pieces of PIECE_BOARDS,
+ * each from its own stream of the seed (see FastRandom), and the pieces
+ * are solved on a thread pool. Each worker adds what its boards show to
+ * tallies of its own as it goes, so nothing is kept per board, and the
+ * tallies are merged at the end; the same seed gives the same report
+ * whatever the number of threads.
+ */
+
+#include "genlib.h"
+#include "consoletool.h"
+#include "board.h"
+#include "lexicon.h"
+#include "bogglesolver.h"
+#include "threadpool.h"
+#include "fastrandom.h"
+#include "wordindexset.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+
+
+/* Constants
+ * ---------
+ */
+
+const int PIECE_BOARDS = 1000;		// boards dealt from each stream of the seed
+const double PERCENTILES[] = { 1, 5, 10, 25, 50, 75, 90, 95, 99 };
+const int NUM_PERCENTILES = sizeof(PERCENTILES) / sizeof(PERCENTILES[0]);
+
+
+/* Struct: tallyT
+ * --------------
+ * What a worker has counted so far: for each measure, the number of
+ * boards that had each value of it, and for each word of the lexicon,
+ * by index, the number of boards it was on.
+ */
+
+struct tallyT {
+	long long numBoards;
+	std::vector<long long> scores, wordCounts, longest;
+	std::vector<long long> boardsWithWord;
+	WordIndexSet found;			// scratch space for each board's words
+};
+
+
+/* Struct: settingsT
+ * -----------------
+ * The options, and what every piece shares.
+ */
+
+struct settingsT {
+	const Lexicon *lex;
+	std::vector<int> wordLengths;	// for each word index
+	long long numBoards;
+	unsigned long long seed;
+	std::vector<tallyT> *tallies;	// one for each worker of the pool
+};
+
+
+/* Struct: pieceT
+ * --------------
+ * A numbered run of boards to deal and solve.
+ */
+
+struct pieceT {
+	const settingsT *settings;
+	long long index;
+};
+
+
+// Adds one to the count for value, making room for it if need be.
+static void Count(std::vector<long long> & histogram, int value)
+{
+	if (value >= histogram.size()) histogram.resize(value + 1, 0);
+	histogram[value]++;
+}
+
+template <typename BoardType>
+  static void SolvePiece(void *data, int worker)
+{
+	pieceT & piece = *(pieceT *)data;
+	const settingsT & settings = *piece.settings;
+	tallyT & tally = (*settings.tallies)[worker];
+	FastRandom rng(settings.seed, piece.index);
+	long long first = piece.index * PIECE_BOARDS;
+	long long last = std::min(first + PIECE_BOARDS, settings.numBoards);
+	BoardType board;
+	for (long long i = first; i < last; i++) {
+		board.shake(rng);
+		int score = ScoreBoard(board, *settings.lex, tally.found);
+		int longest = 0;
+		for (int j = 0; j < tally.found.size(); j++) {
+			int index = tally.found[j];
+			tally.boardsWithWord[index]++;
+			longest = std::max(longest, settings.wordLengths[index]);
+		}
+		Count(tally.scores, score);
+		Count(tally.wordCounts, tally.found.size());
+		Count(tally.longest, longest);
+		tally.numBoards++;
+	}
+}
+
+// Adds the counts of another tally's histogram into one.
+static void Merge(std::vector<long long> & into, const std::vector<long long> & from)
+{
+	if (from.size() > into.size()) into.resize(from.size(), 0);
+	for (int value = 0; value < from.size(); value++)
+		into[value] += from[value];
+}
+
+// Writes a measure's line of the percentile table. A percentile is the
+// smallest value at least that share of the boards are at or below.
+static void WritePercentiles(string name, const std::vector<long long> & histogram, long long numBoards)
+{
+	long long total = 0;
+	int min = -1, max = 0;
+	for (int value = 0; value < histogram.size(); value++) {
+		if (histogram[value] == 0) continue;
+		total += value * histogram[value];
+		if (min == -1) min = value;
+		max = value;
+	}
+	cout << name << '\t' << fixed << setprecision(2) << (double)total / numBoards << '\t' << min;
+	long long seen = 0;
+	int value = 0;
+	for (int i = 0; i < NUM_PERCENTILES; i++) {
+		while (seen + histogram[value] < PERCENTILES[i] / 100 * numBoards)
+			seen += histogram[value++];
+		cout << '\t' << value;
+	}
+	cout << '\t' << max << '\n';
+}
+
+static void WriteHistogram(string name, const std::vector<long long> & histogram)
+{
+	for (int value = 0; value < histogram.size(); value++) {
+		if (histogram[value] != 0) cout << name << '\t' << value << '\t' << histogram[value] << '\n';
+	}
+}
+
+// Orders word indexes by the number of boards they were on, most first,
+// and alphabetically among equals.
+struct moreBoardsT {
+	const std::vector<long long> *boardsWithWord;
+	bool operator()(int a, int b) const
+	{
+		if ((*boardsWithWord)[a] != (*boardsWithWord)[b]) return (*boardsWithWord)[a] > (*boardsWithWord)[b];
+		return a < b;
+	}
+};
+
+static void WriteTopWords(const Lexicon & lex, const std::vector<long long> & boardsWithWord, long long numBoards,
+						  int numTop)
+{
+	std::vector<int> indexes;
+	for (int i = 0; i < boardsWithWord.size(); i++) {
+		if (boardsWithWord[i] != 0) indexes.push_back(i);
+	}
+	numTop = std::min(numTop, (int)indexes.size());
+	moreBoardsT order = { &boardsWithWord };
+	std::partial_sort(indexes.begin(), indexes.begin() + numTop, indexes.end(), order);
+	cout << "word\tboards\tfraction\n";
+	for (int i = 0; i < numTop; i++) {
+		long long count = boardsWithWord[indexes[i]];
+		cout << lex.wordAt(indexes[i]) << '\t' << count << '\t' << setprecision(4) << (double)count / numBoards << '\n';
+	}
+}
+
+static void Usage()
+{
+	cerr << "Usage: bogglesample [-big] [-boards n] [-seed n] [-threads n] [-top n]" << endl
+		 << "                    [-histograms] [-lexicon file]" << endl;
+	exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+	settingsT settings;
+	settings.numBoards = 100000;
+	settings.seed = 1;
+	bool big = false, histograms = false;
+	int numThreads = 0, numTop = 20;
+	string lexiconFile = "lexicon.dat";
+	for (int arg = 1; arg < argc; arg++) {
+		string flag = argv[arg];
+		if (flag == "-big") {
+			big = true;
+		} else if (flag == "-histograms") {
+			histograms = true;
+		} else if (flag == "-boards" && arg + 1 < argc) {
+			settings.numBoards = strtoll(argv[++arg], NULL, 10);
+		} else if (flag == "-seed" && arg + 1 < argc) {
+			settings.seed = strtoull(argv[++arg], NULL, 10);
+		} else if (flag == "-threads" && arg + 1 < argc) {
+			numThreads = atoi(argv[++arg]);
+		} else if (flag == "-top" && arg + 1 < argc) {
+			numTop = atoi(argv[++arg]);
+		} else if (flag == "-lexicon" && arg + 1 < argc) {
+			lexiconFile = argv[++arg];
+		} else {
+			Usage();
+		}
+	}
+	if (settings.numBoards <= 0 || numTop < 0) Usage();
+
+	Lexicon lex(lexiconFile);
+	settings.lex = &lex;
+	for (int i = 0; i < lex.size(); i++)
+		settings.wordLengths.push_back(lex.wordAt(i).length());
+	ThreadPool pool(numThreads);
+	std::vector<tallyT> tallies(pool.numWorkers());
+	for (int i = 0; i < tallies.size(); i++) {
+		tallies[i].numBoards = 0;
+		tallies[i].boardsWithWord.resize(lex.size(), 0);
+	}
+	settings.tallies = &tallies;
+
+	long long numPieces = (settings.numBoards + PIECE_BOARDS - 1) / PIECE_BOARDS;
+	std::vector<pieceT> pieces(numPieces);
+	for (long long i = 0; i < numPieces; i++) {
+		pieces[i].settings = &settings;
+		pieces[i].index = i;
+		pool.submit(big ? SolvePiece<BigBoard> : SolvePiece<StandardBoard>, &pieces[i]);
+	}
+	pool.wait();
+
+	tallyT total;
+	total.numBoards = 0;
+	total.boardsWithWord.resize(lex.size(), 0);
+	for (int i = 0; i < tallies.size(); i++) {
+		total.numBoards += tallies[i].numBoards;
+		Merge(total.scores, tallies[i].scores);
+		Merge(total.wordCounts, tallies[i].wordCounts);
+		Merge(total.longest, tallies[i].longest);
+		Merge(total.boardsWithWord, tallies[i].boardsWithWord);
+	}
+
+	cout << "boards\t" << total.numBoards << '\n';
+	cout << "measure\tmean\tmin";
+	for (int i = 0; i < NUM_PERCENTILES; i++)
+		cout << '\t' << PERCENTILES[i] << '%';
+	cout << "\tmax\n";
+	WritePercentiles("score", total.scores, total.numBoards);
+	WritePercentiles("words", total.wordCounts, total.numBoards);
+	WritePercentiles("longest", total.longest, total.numBoards);
+	if (histograms) {
+		WriteHistogram("score", total.scores);
+		WriteHistogram("words", total.wordCounts);
+		WriteHistogram("longest", total.longest);
+	}
+	WriteTopWords(lex, total.boardsWithWord, total.numBoards, numTop);
+	return 0;
+}
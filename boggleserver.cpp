@@ -0,0 +1,595 @@
+/*
+ * File: boggleserver.cpp
+ * ----------------------
+ * A server that hosts many Boggle games at once, for group events where
+ * lots of players enter words against the same boards at the same time.
+ * Clients connect over TCP and send one command per line:
+ *
+ *	NEW [BIG]		starts a game, replying GAME id letters words score,
+ *				with the board and the number of words and points on it
+ *	JOIN id name		joins that game under the name, replying JOINED id letters
+ *	WORD word		enters a word in the game joined
+ *	SCORES			replies SCORE name points words for each player in the
+ *				game, then END
+ *	MISSED			replies MISSED and the words on the board no player in
+ *				the game has found yet
+ *	QUIT			closes the connection
+ *
+ * Anything else gets ERROR and a message.
+ *
+ * Usage: boggleserver [-port n] [-threads n] [-flush ms] [-lexicon file]
+ *
+ * All the games share one read-only lexicon. Each board is shaken and
+ * solved with SolveBoardParallel as its game is made, which gives the
+ * totals NEW reports and the words MISSED lists. Words are checked on a
+ * thread pool by the same rules the game uses, CheckWord plus each
+ * player finding a word only once, so games don't wait on one another;
+ * boards are solved on a second pool, since waiting for a pool waits for
+ * everything on it, and a NEW would otherwise wait for every check.
+ * The results, OK word points or NO word reason, and the new scores, a
+ * SCORE line to everyone in the game for each player whose score
+ * changed, aren't sent as each word is checked; they are gathered and
+ * sent together every -flush milliseconds (100 by default), so a busy
+ * game gets a few large writes instead of one per word. A single thread
+ * does all the reading and writing, with poll. A game is freed once the
+ * player who made it has disconnected, everyone who joined it has too,
+ * and their last words have been checked. Each connection may make only
+ * MAX_GAMES_PER_PLAYER games, since solving a board holds up the thread
+ * that serves every client.
+ */
+
+#include "genlib.h"
+#include "consoletool.h"
+#include "strutils.h"
+#include "random.h"
+#include "board.h"
+#include "lexicon.h"
+#include "sharedlexicon.h"
+#include "bogglesolver.h"
+#include "threadpool.h"
+#include "wordindexset.h"
+#include "walltime.h"
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <map>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <csignal>
+#include <pthread.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+
+/* Constants
+ * ---------
+ */
+
+const int DEFAULT_PORT = 4242;
+const int DEFAULT_FLUSH_MS = 100;
+const int MAX_LINE_LENGTH = 1000;		// a client sending a longer line is cut off
+const int MAX_GAMES_PER_PLAYER = 10;	// NEW commands allowed on one connection
+
+
+struct gameT;
+
+/* Struct: clientT
+ * ---------------
+ * One connection. The server thread alone uses the socket and the
+ * buffers; once the player has joined a game, the fields after name are
+ * shared with the checking tasks and guarded by the game's lock.
+ */
+
+struct clientT {
+	int fd;
+	string input, output;			// text read but not yet handled, and waiting to be written
+	bool quitting;					// close once output is written
+	gameT *game;					// NULL until JOIN
+	int gamesMade;					// by NEW
+	string name;
+	WordIndexSet found;
+	int score, numWords;
+	bool scoreChanged;				// since the last flush
+	string replies;					// results of checks, for the next flush
+	int pendingChecks;				// tasks that still refer to the player
+};
+
+
+/* Struct: gameT
+ * -------------
+ * One board and the players on it. Everything but players, found by
+ * the server thread and the checks alike, is set when the game is made
+ * and only read after that, except maker, which only the server thread
+ * uses.
+ */
+
+struct gameT {
+	int id;
+	clientT *maker;					// NULL once the player who sent NEW has disconnected
+	const Lexicon *lex;
+	bool big;
+	StandardBoard standardBoard;
+	BigBoard bigBoard;
+	WordIndexSet solution;			// every word on the board
+	int maxScore;
+	pthread_mutex_t lock;			// guards players and the shared fields of each
+	Vector<clientT *> players;
+	bool scoresChanged;				// some player's scoreChanged is set
+};
+
+
+/* Struct: checkT
+ * --------------
+ * A word waiting to be checked on the pool.
+ */
+
+struct checkT {
+	gameT *game;
+	clientT *player;
+	string word;
+};
+
+
+/* Struct: serverT
+ * ---------------
+ * The state of the server thread.
+ */
+
+struct serverT {
+	SharedLexicon lex;
+	ThreadPool *pool;					// for checking words
+	ThreadPool *solvePool;				// for solving new boards, so NEW never waits on word checks
+	std::map<int, gameT *> games;
+	int nextGameId;
+	std::vector<clientT *> players;		// connected, in the order they connected
+	std::vector<clientT *> leaving;		// disconnected, freed once no check refers to them
+};
+
+
+/* Checking words
+ * --------------
+ */
+
+static const char *ReasonName(wordCheckT result)
+{
+	switch (result) {
+		case WordTooShort: return "too-short";
+		case WordNotInLexicon: return "not-a-word";
+		case WordNotOnBoard: return "not-on-board";
+		default: return "accepted";
+	}
+}
+
+// Checks one word against the rules of the player's game and records
+// the result for the next flush.
+static void CheckSubmission(void *data, int worker)
+{
+	checkT *check = (checkT *)data;
+	gameT & game = *check->game;
+	int path[BigBoard::NUM_CELLS];
+	wordCheckT result = game.big ? CheckWord(game.bigBoard, *game.lex, check->word, path)
+								 : CheckWord(game.standardBoard, *game.lex, check->word, path);
+	pthread_mutex_lock(&game.lock);
+	clientT & player = *check->player;
+	if (result != WordAccepted) {
+		player.replies += "NO " + check->word + " " + ReasonName(result) + "\n";
+	} else if (!player.found.add(game.lex->indexOf(check->word))) {
+		player.replies += "NO " + check->word + " already-found\n";
+	} else {
+		int points = ScoreForWord(check->word);
+		player.score += points;
+		player.numWords++;
+		player.scoreChanged = game.scoresChanged = true;
+		player.replies += "OK " + check->word + " " + IntegerToString(points) + "\n";
+	}
+	player.pendingChecks--;
+	pthread_mutex_unlock(&game.lock);
+	delete check;
+}
+
+
+/* Games
+ * -----
+ */
+
+template <typename BoardType>
+  static void SolveNewBoard(BoardType & board, gameT & game, ThreadPool & pool)
+{
+	board.shake();
+	Set<string> wordsSeen;
+	Vector<string> found;
+	SolveBoardParallel(board, *game.lex, wordsSeen, found, pool);
+	game.maxScore = 0;
+	for (int i = 0; i < found.size(); i++) {
+		game.solution.add(game.lex->indexOf(found[i]));
+		game.maxScore += ScoreForWord(found[i]);
+	}
+}
+
+static gameT *NewGame(serverT & server, clientT & maker, bool big)
+{
+	gameT *game = new gameT;
+	game->id = server.nextGameId++;
+	game->maker = &maker;
+	game->lex = &*server.lex;
+	game->big = big;
+	if (big) SolveNewBoard(game->bigBoard, *game, *server.solvePool);
+	else SolveNewBoard(game->standardBoard, *game, *server.solvePool);
+	pthread_mutex_init(&game->lock, NULL);
+	game->scoresChanged = false;
+	server.games[game->id] = game;
+	return game;
+}
+
+static string BoardLetters(gameT & game)
+{
+	return game.big ? game.bigBoard.toString() : game.standardBoard.toString();
+}
+
+static string ScoreLine(clientT & player)
+{
+	return "SCORE " + player.name + " " + IntegerToString(player.score) + " "
+		   + IntegerToString(player.numWords) + "\n";
+}
+
+// Moves each player's check results, and the scores that changed, into
+// the players' output. This is the only place results reach clients, so
+// however many words come in, each game is written to once per flush.
+static void FlushGame(gameT & game)
+{
+	pthread_mutex_lock(&game.lock);
+	string scores;
+	if (game.scoresChanged) {
+		for (int i = 0; i < game.players.size(); i++) {
+			if (game.players[i]->scoreChanged) scores += ScoreLine(*game.players[i]);
+			game.players[i]->scoreChanged = false;
+		}
+		game.scoresChanged = false;
+	}
+	for (int i = 0; i < game.players.size(); i++) {
+		clientT & player = *game.players[i];
+		player.output += player.replies + scores;
+		player.replies.clear();
+	}
+	pthread_mutex_unlock(&game.lock);
+}
+
+
+/* Commands
+ * --------
+ */
+
+static void HandleJoin(serverT & server, clientT & player, istringstream & args)
+{
+	int id;
+	string name;
+	if (!(args >> id >> name)) {
+		player.output += "ERROR usage: JOIN id name\n";
+	} else if (player.game != NULL) {
+		player.output += "ERROR already in a game\n";
+	} else if (server.games.count(id) == 0) {
+		player.output += "ERROR no game " + IntegerToString(id) + "\n";
+	} else {
+		gameT & game = *server.games[id];
+		pthread_mutex_lock(&game.lock);
+		player.game = &game;
+		player.name = name;
+		game.players.add(&player);
+		pthread_mutex_unlock(&game.lock);
+		player.output += "JOINED " + IntegerToString(id) + " " + BoardLetters(game) + "\n";
+	}
+}
+
+static void HandleWord(serverT & server, clientT & player, istringstream & args)
+{
+	string word;
+	if (!(args >> word)) {
+		player.output += "ERROR usage: WORD word\n";
+	} else if (player.game == NULL) {
+		player.output += "ERROR join a game first\n";
+	} else {
+		checkT *check = new checkT;
+		check->game = player.game;
+		check->player = &player;
+		check->word = ConvertToUpperCase(word);
+		pthread_mutex_lock(&player.game->lock);
+		player.pendingChecks++;
+		pthread_mutex_unlock(&player.game->lock);
+		server.pool->submit(CheckSubmission, check);
+	}
+}
+
+static void HandleScores(clientT & player)
+{
+	if (player.game == NULL) {
+		player.output += "ERROR join a game first\n";
+		return;
+	}
+	gameT & game = *player.game;
+	pthread_mutex_lock(&game.lock);
+	for (int i = 0; i < game.players.size(); i++)
+		player.output += ScoreLine(*game.players[i]);
+	pthread_mutex_unlock(&game.lock);
+	player.output += "END\n";
+}
+
+static void HandleMissed(clientT & player)
+{
+	if (player.game == NULL) {
+		player.output += "ERROR join a game first\n";
+		return;
+	}
+	gameT & game = *player.game;
+	string line = "MISSED";
+	pthread_mutex_lock(&game.lock);
+	for (int i = 0; i < game.solution.size(); i++) {
+		bool foundByAnyone = false;
+		for (int j = 0; j < game.players.size() && !foundByAnyone; j++)
+			foundByAnyone = game.players[j]->found.contains(game.solution[i]);
+		if (!foundByAnyone) line += " " + ConvertToUpperCase(game.lex->wordAt(game.solution[i]));
+	}
+	pthread_mutex_unlock(&game.lock);
+	player.output += line + "\n";
+}
+
+static void HandleCommand(serverT & server, clientT & player, string line)
+{
+	istringstream args(line);
+	string command;
+	if (!(args >> command)) return;			// blank lines are ignored
+	command = ConvertToUpperCase(command);
+	if (command == "NEW") {
+		string size;
+		args >> size;
+		if (player.gamesMade == MAX_GAMES_PER_PLAYER) {
+			player.output += "ERROR no more than " + IntegerToString(MAX_GAMES_PER_PLAYER) + " games per connection\n";
+			return;
+		}
+		player.gamesMade++;
+		gameT *game = NewGame(server, player, ConvertToUpperCase(size) == "BIG");
+		player.output += "GAME " + IntegerToString(game->id) + " " + BoardLetters(*game) + " "
+						 + IntegerToString(game->solution.size()) + " " + IntegerToString(game->maxScore) + "\n";
+	} else if (command == "JOIN") {
+		HandleJoin(server, player, args);
+	} else if (command == "WORD") {
+		HandleWord(server, player, args);
+	} else if (command == "SCORES") {
+		HandleScores(player);
+	} else if (command == "MISSED") {
+		HandleMissed(player);
+	} else if (command == "QUIT") {
+		player.quitting = true;
+	} else {
+		player.output += "ERROR unknown command " + command + "\n";
+	}
+}
+
+
+/* Connections
+ * -----------
+ */
+
+static void SetNonBlocking(int fd)
+{
+	fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+}
+
+static int OpenListener(int port)
+{
+	int fd = socket(AF_INET, SOCK_STREAM, 0);
+	if (fd == -1) Error("boggleserver couldn't make a socket.");
+	int on = 1;
+	setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+	struct sockaddr_in address;
+	memset(&address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_ANY);
+	address.sin_port = htons(port);
+	if (bind(fd, (struct sockaddr *)&address, sizeof(address)) == -1 || listen(fd, SOMAXCONN) == -1)
+		Error("boggleserver couldn't listen on port " + IntegerToString(port) + ".");
+	SetNonBlocking(fd);
+	return fd;
+}
+
+static void AcceptPlayers(serverT & server, int listener)
+{
+	while (true) {
+		int fd = accept(listener, NULL, NULL);
+		if (fd == -1) return;
+		SetNonBlocking(fd);
+		clientT *player = new clientT;
+		player->fd = fd;
+		player->quitting = false;
+		player->game = NULL;
+		player->gamesMade = 0;
+		player->score = player->numWords = 0;
+		player->scoreChanged = false;
+		player->pendingChecks = 0;
+		server.players.push_back(player);
+	}
+}
+
+// Reads what the player has sent and handles each whole line. Returns
+// false once the connection has closed.
+static bool ReadPlayer(serverT & server, clientT & player)
+{
+	char buffer[4096];
+	while (true) {
+		int count = read(player.fd, buffer, sizeof(buffer));
+		if (count == 0) return false;
+		if (count < 0) {
+			if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) return false;
+			break;
+		}
+		player.input.append(buffer, count);
+	}
+	size_t end;
+	while (!player.quitting && (end = player.input.find('\n')) != string::npos) {
+		string line = player.input.substr(0, end);
+		player.input.erase(0, end + 1);
+		if (!line.empty() && line[line.length() - 1] == '\r') line.erase(line.length() - 1);
+		HandleCommand(server, player, line);
+	}
+	return player.input.length() <= MAX_LINE_LENGTH;
+}
+
+// Writes as much waiting output as the socket takes. Returns false if
+// the connection has failed.
+static bool WritePlayer(clientT & player)
+{
+	while (!player.output.empty()) {
+		int count = write(player.fd, player.output.data(), player.output.length());
+		if (count < 0) return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+		player.output.erase(0, count);
+	}
+	return true;
+}
+
+// Takes a player off the list of connections and out of its game. The
+// player is freed later, once no check still refers to it.
+static void Disconnect(serverT & server, int index)
+{
+	clientT *player = server.players[index];
+	close(player->fd);
+	server.players.erase(server.players.begin() + index);
+	if (player->gamesMade > 0) {
+		for (std::map<int, gameT *>::iterator it = server.games.begin(); it != server.games.end(); ++it)
+			if (it->second->maker == player) it->second->maker = NULL;
+	}
+	if (player->game == NULL) {
+		delete player;
+		return;
+	}
+	gameT & game = *player->game;
+	pthread_mutex_lock(&game.lock);
+	for (int i = 0; i < game.players.size(); i++) {
+		if (game.players[i] == player) {
+			game.players.removeAt(i);
+			break;
+		}
+	}
+	pthread_mutex_unlock(&game.lock);
+	server.leaving.push_back(player);
+}
+
+static void FreeLeavingPlayers(serverT & server)
+{
+	for (int i = server.leaving.size() - 1; i >= 0; i--) {
+		clientT *player = server.leaving[i];
+		pthread_mutex_lock(&player->game->lock);
+		bool done = (player->pendingChecks == 0);
+		pthread_mutex_unlock(&player->game->lock);
+		if (done) {
+			delete player;
+			server.leaving.erase(server.leaving.begin() + i);
+		}
+	}
+}
+
+// Frees each game whose maker and players have all gone. Run after
+// FreeLeavingPlayers, so that a game still waiting on a departed
+// player's checks is the game of some player in leaving.
+static void FreeFinishedGames(serverT & server)
+{
+	std::map<int, gameT *>::iterator it = server.games.begin();
+	while (it != server.games.end()) {
+		gameT *game = it->second;
+		bool done = (game->maker == NULL);
+		if (done) {
+			pthread_mutex_lock(&game->lock);
+			done = game->players.isEmpty();
+			pthread_mutex_unlock(&game->lock);
+		}
+		for (int i = 0; i < server.leaving.size() && done; i++)
+			done = (server.leaving[i]->game != game);
+		if (done) {
+			pthread_mutex_destroy(&game->lock);
+			delete game;
+			server.games.erase(it++);
+		} else {
+			++it;
+		}
+	}
+}
+
+static void Serve(serverT & server, int listener, double flushSeconds)
+{
+	double nextFlush = CurrentTime() + flushSeconds;
+	std::vector<struct pollfd> polls;
+	while (true) {
+		polls.clear();
+		struct pollfd accepting = { listener, POLLIN, 0 };
+		polls.push_back(accepting);
+		for (int i = 0; i < server.players.size(); i++) {
+			struct pollfd client = { server.players[i]->fd, POLLIN, 0 };
+			if (!server.players[i]->output.empty()) client.events |= POLLOUT;
+			polls.push_back(client);
+		}
+		int timeout = (int)((nextFlush - CurrentTime()) * 1000);
+		poll(&polls[0], polls.size(), (timeout > 0) ? timeout : 0);
+
+		if (polls[0].revents & POLLIN) AcceptPlayers(server, listener);
+		for (int i = polls.size() - 1; i > 0; i--) {		// backward, since players may be removed
+			clientT & player = *server.players[i - 1];
+			bool open = true;
+			if (polls[i].revents & (POLLIN | POLLHUP | POLLERR)) open = ReadPlayer(server, player);
+			if (open && (polls[i].revents & POLLOUT)) open = WritePlayer(player);
+			if (!open || (player.quitting && player.output.empty())) Disconnect(server, i - 1);
+		}
+
+		if (CurrentTime() >= nextFlush) {
+			for (std::map<int, gameT *>::iterator it = server.games.begin(); it != server.games.end(); ++it)
+				FlushGame(*it->second);
+			for (int i = server.players.size() - 1; i >= 0; i--) {
+				if (!WritePlayer(*server.players[i])) Disconnect(server, i);
+			}
+			FreeLeavingPlayers(server);
+			FreeFinishedGames(server);
+			nextFlush = CurrentTime() + flushSeconds;
+		}
+	}
+}
+
+static void Usage()
+{
+	cerr << "Usage: boggleserver [-port n] [-threads n] [-flush ms] [-lexicon file]" << endl;
+	exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+	int port = DEFAULT_PORT, numThreads = 0, flushMs = DEFAULT_FLUSH_MS;
+	string lexiconFile = "lexicon.dat";
+	for (int arg = 1; arg < argc; arg++) {
+		string flag = argv[arg];
+		if (flag == "-port" && arg + 1 < argc) {
+			port = atoi(argv[++arg]);
+		} else if (flag == "-threads" && arg + 1 < argc) {
+			numThreads = atoi(argv[++arg]);
+		} else if (flag == "-flush" && arg + 1 < argc) {
+			flushMs = atoi(argv[++arg]);
+		} else if (flag == "-lexicon" && arg + 1 < argc) {
+			lexiconFile = argv[++arg];
+		} else {
+			Usage();
+		}
+	}
+	if (port <= 0 || flushMs <= 0) Usage();
+
+	signal(SIGPIPE, SIG_IGN);		// a client that goes away shows up as a failed write instead
+	Randomize();
+	serverT server;
+	server.lex = SharedLexicon::load(lexiconFile);
+	ThreadPool pool(numThreads), solvePool(numThreads);
+	server.pool = &pool;
+	server.solvePool = &solvePool;
+	server.nextGameId = 1;
+	int listener = OpenListener(port);
+	cerr << "boggleserver: listening on port " << port << endl;
+	Serve(server, listener, flushMs / 1000.0);
+	return 0;
+}
@@ -0,0 +1,525 @@
+/*
+ * File: bogglesolver.cpp
+ * ----------------------
+ * Implements the board solver. The search is the same whether it runs
+ * serially or in parallel: a depth-first walk of the board from some
+ * starting path, carrying a lexicon cursor so that every step checks one
+ * more letter, and stopping as soon as no word begins with the letters
+ * traced. The parallel version just runs many of these walks at once,
+ * each from its own starting path into its own list of words. Words are
+ * found as lexicon indexes, taken from the cursor, and only turned into
+ * strings for the callers that want them.
+ */
+
+#include "bogglesolver.h"
+#include "bogglestats.h"
+#include "strutils.h"
+#include <cmath>
+
+
+/* Struct: searchT
+ * ---------------
+ * One independent piece of the search: every path that begins with the
+ * given cells. secondCell is -1 if the piece covers all paths from
+ * firstCell. Each piece keeps its own list of the indexes of the words
+ * it finds, in the order it finds them; a word found again along another
+ * path is listed again, and the repeats are dropped when the pieces are
+ * merged. A search for ScoreBoard instead adds each word to unique as
+ * it goes, scoring the ones that are new, and one for SolveBoardWords
+ * also spells each new word from prefix, the letters of the path so far,
+ * into words. In stats builds each piece also counts its own work, so the
+ * threads never share a counter.
+ *
+ * A dictionary-first piece instead covers every word beginning with
+ * firstLetter, and keeps the ends of the paths that spell the prefix it
+ * has reached, and of the prefixes leading to it, in paths.
+ */
+
+/* Struct: pathEndT
+ * -----------------
+ * The last cube of a path on the board, and the cubes the path has used.
+ */
+
+struct pathEndT {
+	int cell;
+	cellSetT visited;
+};
+
+template <typename BoardType>
+  struct searchT {
+	const BoardType *board;
+	const Lexicon *lex;
+	int firstCell, secondCell;
+	int firstLetter;			// -1 unless searching dictionary-first
+	unsigned int boardLetters;	// the letters showing, one bit each as in Cursor::nextLetters
+	std::vector<pathEndT> paths;
+	Vector<int> found;
+	WordIndexSet *unique;		// NULL unless scoring
+	int score;
+	WordArena *words;			// NULL unless spelling the words too
+	char prefix[BoardType::NUM_CELLS];
+	STATS_ONLY(searchStatsT stats;)
+};
+
+
+// Returns the bit for a letter in the masks the searches and
+// PruneLexiconForBoard use, or 0 for anything that isn't a letter.
+static unsigned int LetterBit(char ch)
+{
+	ch = tolower(ch);
+	return (ch >= 'a' && ch <= 'z') ? 1u << (ch - 'a') : 0;
+}
+
+// Returns the letters the board shows, as a mask of their bits.
+template <typename BoardType>
+  static unsigned int LettersShowing(const BoardType & board)
+{
+	unsigned int letters = 0;
+	for (int cell = 0; cell < BoardType::NUM_CELLS; cell++)
+		letters |= LetterBit(board.letterAt(cell));
+	return letters;
+}
+
+// Scores a word a scoring search has found for the first time, spelled
+// by the first length letters of its prefix, and spells it into words
+// if the search keeps them.
+template <typename BoardType>
+  static void AddNewWord(searchT<BoardType> & search, int length)
+{
+	search.score += ScoreForLength(length);
+	if (search.words == NULL) return;
+	char spelling[BoardType::NUM_CELLS];
+	for (int i = 0; i < length; i++)
+		spelling[i] = tolower(search.prefix[i]);
+	search.words->add(spelling, length);
+}
+
+// Tallies a word the search has reached, spelled by the first length
+// letters of its prefix.
+template <typename BoardType>
+  static void AddWord(searchT<BoardType> & search, int index, int length)
+{
+	if (search.unique == NULL) search.found.add(index);
+	else if (search.unique->add(index)) AddNewWord(search, length);
+	STATS_COUNT(search.stats.wordsFound);
+}
+
+
+/* Function: FindAllWords
+ * ----------------------
+ * This function finds all the words that start with the path traced so far and
+ * continue through the given cell, calling itself recursively on each neighbor.
+ * The function bottoms out if the dictionary doesn't contain any words with the
+ * prefix that is being explored. The lexicon cursor passed down remembers the
+ * prefix traced so far, so each step only needs to look up the newest letter,
+ * and the cubes already visited are kept as a set of bits. The cubes worth
+ * stepping to next are the neighbors, less the visited cubes, that show one
+ * of the letters the cursor can take, which is a few bit operations on the
+ * board's cell sets, so no neighbor is tried only to fail. The letters of
+ * the path are kept in the search's one prefix buffer, each step writing
+ * its own, so a word can be spelled without going back to the lexicon.
+ * Nothing is allocated along the way.
+ */
+
+template <typename BoardType>
+  static void FindAllWords(searchT<BoardType> & search, int cell, Lexicon::Cursor cursor, cellSetT visited)
+{
+	visited = CellSetAdd(visited, cell);
+	STATS_COUNT(search.stats.nodesExpanded);
+	STATS_COUNT(search.stats.childLookups);
+	char letter = search.board->letterAt(cell);
+	if (!cursor.advance(letter)) {					// dead end
+		STATS_COUNT(search.stats.prefixPruned);
+		return;
+	}
+	search.prefix[cursor.length() - 1] = letter;
+	if (cursor.length() >= MIN_WORD_LENGTH) {
+		int index = cursor.wordIndex();
+		if (index != -1) AddWord(search, index, cursor.length());
+	}
+	STATS_COUNT(search.stats.prefixChecks);
+	unsigned int nextLetters = cursor.nextLetters();
+	if (nextLetters == 0) {							// no longer words begin with this prefix
+		STATS_COUNT(search.stats.prefixPruned);
+		return;
+	}
+	cellSetT candidates = BoardType::neighborMask(cell) & ~visited & search.board->cellsWithLetters(nextLetters);
+	for (; candidates != 0; candidates &= candidates - 1) {
+		FindAllWords(search, CellSetFirst(candidates), cursor, visited);
+	}
+}
+
+/* Function: FindDictionaryWords
+ * -----------------------------
+ * This function is the dictionary-first search: it finds all the words that
+ * start with the prefix the cursor has traced, given the ends of every path
+ * on the board that spells it, which are paths[begin] to paths[end - 1]. It
+ * goes through the letters the prefix can be followed by in the lexicon, and
+ * for each one the board shows, steps every path onto the unused neighbors
+ * showing it, appending the new ends after end; if there are any, the
+ * longer prefix is searched the same way, and its paths are then dropped
+ * again. The paths vector is used as a stack, so it only allocates while
+ * it grows to the most paths the search needs at once. Each prefix is
+ * visited once, however many paths spell it, and words are found in the
+ * lexicon's order.
+ */
+
+template <typename BoardType>
+  static void FindDictionaryWords(searchT<BoardType> & search, Lexicon::Cursor cursor, int begin, int end)
+{
+	if (cursor.length() >= MIN_WORD_LENGTH) {
+		int index = cursor.wordIndex();
+		if (index != -1) AddWord(search, index, cursor.length());
+	}
+	STATS_COUNT(search.stats.prefixChecks);
+	unsigned int nextLetters = cursor.nextLetters() & search.boardLetters;
+	if (nextLetters == 0) {
+		STATS_COUNT(search.stats.prefixPruned);
+		return;
+	}
+	for (; nextLetters != 0; nextLetters &= nextLetters - 1) {
+		cellSetT showing = search.board->cellsWithLetters(nextLetters & -nextLetters);
+		int next = search.paths.size();
+		for (int i = begin; i < end; i++) {
+			pathEndT path = search.paths[i];
+			cellSetT candidates = BoardType::neighborMask(path.cell) & ~path.visited & showing;
+			for (; candidates != 0; candidates &= candidates - 1) {
+				pathEndT step = { CellSetFirst(candidates), CellSetAdd(path.visited, CellSetFirst(candidates)) };
+				search.paths.push_back(step);
+				STATS_COUNT(search.stats.nodesExpanded);
+			}
+		}
+		if (search.paths.size() == next) {				// the letter is showing, but on no cube in reach
+			STATS_COUNT(search.stats.prefixPruned);
+			continue;
+		}
+		char letter = search.board->letterAt(search.paths[next].cell);
+		Lexicon::Cursor longer = cursor;
+		longer.advance(letter);
+		STATS_COUNT(search.stats.childLookups);
+		search.prefix[cursor.length()] = letter;
+		FindDictionaryWords(search, longer, next, search.paths.size());
+		search.paths.resize(next);
+	}
+}
+
+// Runs a dictionary-first piece, starting from every cube that shows its
+// letter.
+template <typename BoardType>
+  static void RunDictionarySearch(searchT<BoardType> & search)
+{
+	cellSetT starts = search.board->cellsWithLetters(1u << search.firstLetter);
+	if (starts == 0) return;
+	char letter = search.board->letterAt(CellSetFirst(starts));
+	Lexicon::Cursor cursor = search.lex->cursor();
+	STATS_COUNT(search.stats.childLookups);
+	if (!cursor.advance(letter)) return;
+	search.paths.clear();
+	for (; starts != 0; starts &= starts - 1) {
+		pathEndT start = { CellSetFirst(starts), CellSetAdd(0, CellSetFirst(starts)) };
+		search.paths.push_back(start);
+		STATS_COUNT(search.stats.nodesExpanded);
+	}
+	search.prefix[0] = letter;
+	FindDictionaryWords(search, cursor, 0, search.paths.size());
+}
+
+// Runs one piece of the search from its starting path.
+template <typename BoardType>
+  static void RunSearch(void *data, int worker)
+{
+	searchT<BoardType> & search = *(searchT<BoardType> *)data;
+	if (search.firstLetter != -1) {
+		RunDictionarySearch(search);
+		return;
+	}
+	if (search.secondCell == -1) {
+		FindAllWords(search, search.firstCell, search.lex->cursor(), 0);
+		return;
+	}
+	Lexicon::Cursor cursor = search.lex->cursor();
+	STATS_COUNT(search.stats.nodesExpanded);
+	STATS_COUNT(search.stats.childLookups);
+	if (!cursor.advance(search.board->letterAt(search.firstCell))) return;
+	search.prefix[0] = search.board->letterAt(search.firstCell);
+	// a single cube is too short to be a word, so only the paths onward matter
+	FindAllWords(search, search.secondCell, cursor, CellSetAdd(0, search.firstCell));
+}
+
+// Splits the search for the board into pieces, listed in the order the
+// serial search would reach them: board-first by starting cube, and
+// dictionary-first by the first letter of the words, for each letter the
+// board shows.
+template <typename BoardType>
+  static void MakeSearches(const BoardType & board, const Lexicon & lex, solveEngineT engine, bool splitBySecondCell,
+						   Vector<searchT<BoardType> *> & searches)
+{
+	bool dictionaryFirst = (engine == DictionaryFirstEngine);
+	bool split = splitBySecondCell && !dictionaryFirst;
+	unsigned int letters = LettersShowing(board);
+	int numStarts = dictionaryFirst ? 26 : BoardType::NUM_CELLS;
+	for (int start = 0; start < numStarts; start++) {
+		if (dictionaryFirst && !(letters & (1u << start))) continue;
+		int numPieces = split ? BoardType::numNeighbors(start) : 1;
+		for (int i = 0; i < numPieces; i++) {
+			searchT<BoardType> *search = new searchT<BoardType>;
+			search->board = &board;
+			search->lex = &lex;
+			search->firstCell = dictionaryFirst ? -1 : start;
+			search->secondCell = split ? BoardType::neighbor(start, i) : -1;
+			search->firstLetter = dictionaryFirst ? start : -1;
+			search->boardLetters = letters;
+			search->unique = NULL;
+			search->score = 0;
+			search->words = NULL;
+			STATS_ONLY(search->stats = searchStatsT();)
+			searches.add(search);
+		}
+	}
+}
+
+// Extends a tracing of the first index letters of word, which ends at cell
+// (-1 before the first letter), and returns true as soon as the whole word
+// has been traced, with path holding its cells. The cubes the next letter
+// can be on are the neighbors showing it that aren't used yet, taken in
+// one go from the board's cell sets.
+template <typename BoardType>
+  static bool TracePath(const BoardType & board, const string & word, int index, int cell, cellSetT used, int path[])
+{
+	if (index == word.length()) return true;
+	cellSetT candidates = board.cellsWithLetter(word[index]) & ~used;
+	if (cell != -1) candidates &= BoardType::neighborMask(cell);
+	for (; candidates != 0; candidates &= candidates - 1) {
+		int next = CellSetFirst(candidates);
+		path[index] = next;
+		if (TracePath(board, word, index + 1, next, CellSetAdd(used, next), path)) return true;
+	}
+	return false;
+}
+
+// Merges the words of each piece in order, dropping repeats, and frees
+// the pieces.
+template <typename BoardType>
+  static void MergeSearches(Vector<searchT<BoardType> *> & searches, WordIndexSet & found)
+{
+	for (int i = 0; i < searches.size(); i++) {
+		Vector<int> & indexes = searches[i]->found;
+		for (int j = 0; j < indexes.size(); j++) {
+			found.add(indexes[j]);
+		}
+		STATS_ONLY(AddSearchStats(searches[i]->stats);)
+		delete searches[i];
+	}
+}
+
+// Appends the words with the given indexes that aren't in wordsSeen,
+// spelled in upper case as on the board.
+static void AddNewWords(const Lexicon & lex, WordIndexSet & indexes, Set<string> & wordsSeen, Vector<string> & found)
+{
+	for (int i = 0; i < indexes.size(); i++) {
+		string word = ConvertToUpperCase(lex.wordAt(indexes[i]));
+		if (!wordsSeen.contains(word)) {
+			wordsSeen.add(word);
+			found.add(word);
+		}
+	}
+}
+
+// Returns true if every cube shows a letter, as the dictionary-first
+// search needs.
+template <typename BoardType>
+  static bool ShowsOnlyLetters(const BoardType & board)
+{
+	for (int cell = 0; cell < BoardType::NUM_CELLS; cell++) {
+		if (!LetterBit(board.letterAt(cell))) return false;
+	}
+	return true;
+}
+
+/*
+ * The cost model behind ChooseSolveEngine. Both engines step the same
+ * paths, but board-first advances a cursor for each of them, while
+ * dictionary-first advances one for each prefix, however many paths
+ * spell it, and pays for going through the prefix's next letters. How
+ * many paths spell a prefix goes with how often the board's letters
+ * repeat, measured as the number of cubes showing the letter of an
+ * average cube; the overhead per prefix goes with how many letters the
+ * lexicon's nodes branch into, which grows about as the log of its size.
+ * Dictionary-first is chosen once the repeats pass
+ *
+ *	DICTIONARY_FIRST_BASE + DICTIONARY_FIRST_PER_LOG_WORD * ln(words + 1)
+ *
+ * which was fitted to timings of both engines on 4x4 and 5x5 boards
+ * drawn from 2 to 26 letters, against lexicons of 20 to 127,000 words;
+ * shaken boards of either size with the real lexicon come out at about
+ * 1.7 and 2.3 repeats, under the 2.8 at which the engines break even.
+ */
+const double DICTIONARY_FIRST_BASE = 1.2;
+const double DICTIONARY_FIRST_PER_LOG_WORD = 0.14;
+
+template <typename BoardType>
+  solveEngineT ChooseSolveEngine(const BoardType & board, const Lexicon & lex)
+{
+	if (!ShowsOnlyLetters(board)) return BoardFirstEngine;
+	int counts[26] = { 0 };
+	for (int cell = 0; cell < BoardType::NUM_CELLS; cell++)
+		counts[tolower(board.letterAt(cell)) - 'a']++;
+	int sumOfSquares = 0;
+	for (int i = 0; i < 26; i++)
+		sumOfSquares += counts[i] * counts[i];
+	double repeats = (double)sumOfSquares / BoardType::NUM_CELLS;
+	double breakEven = DICTIONARY_FIRST_BASE + DICTIONARY_FIRST_PER_LOG_WORD * log(lex.size() + 1.0);
+	return (repeats > breakEven) ? DictionaryFirstEngine : BoardFirstEngine;
+}
+
+// Returns the engine a search asked to use engine should run, counting
+// the choice in stats builds.
+template <typename BoardType>
+  static solveEngineT ResolveEngine(const BoardType & board, const Lexicon & lex, solveEngineT engine)
+{
+	if (engine == AutoEngine || !ShowsOnlyLetters(board)) engine = ChooseSolveEngine(board, lex);
+	STATS_ONLY(AddEngineChoice(engine == DictionaryFirstEngine);)
+	return engine;
+}
+
+template <typename BoardType>
+  void SolveBoardIndexes(const BoardType & board, const Lexicon & lex, WordIndexSet & found, solveEngineT engine)
+{
+	Vector<searchT<BoardType> *> searches;
+	MakeSearches(board, lex, ResolveEngine(board, lex, engine), false, searches);
+	for (int i = 0; i < searches.size(); i++) {
+		RunSearch<BoardType>(searches[i], 0);
+	}
+	MergeSearches(searches, found);
+}
+
+template <typename BoardType>
+  void SolveBoard(const BoardType & board, const Lexicon & lex, Set<string> & wordsSeen, Vector<string> & found,
+				  solveEngineT engine)
+{
+	WordIndexSet indexes;
+	SolveBoardIndexes(board, lex, indexes, engine);
+	AddNewWords(lex, indexes, wordsSeen, found);
+}
+
+// Runs the whole search serially, adding each word to unique, and to
+// words unless it is NULL, the first time it is reached. Returns the
+// total score.
+template <typename BoardType>
+  static int SearchUnique(const BoardType & board, const Lexicon & lex, WordIndexSet & unique, WordArena *words,
+						  solveEngineT engine)
+{
+	searchT<BoardType> search;
+	search.board = &board;
+	search.lex = &lex;
+	search.firstCell = search.secondCell = search.firstLetter = -1;
+	search.boardLetters = LettersShowing(board);
+	search.unique = &unique;
+	search.score = 0;
+	search.words = words;
+	STATS_ONLY(search.stats = searchStatsT();)
+	if (ResolveEngine(board, lex, engine) == DictionaryFirstEngine) {
+		for (int letter = 0; letter < 26; letter++) {
+			if (!(search.boardLetters & (1u << letter))) continue;
+			search.firstLetter = letter;
+			RunSearch<BoardType>(&search, 0);
+		}
+	} else {
+		for (int cell = 0; cell < BoardType::NUM_CELLS; cell++) {
+			search.firstCell = cell;
+			RunSearch<BoardType>(&search, 0);
+		}
+	}
+	STATS_ONLY(AddSearchStats(search.stats);)
+	return search.score;
+}
+
+template <typename BoardType>
+  int ScoreBoard(const BoardType & board, const Lexicon & lex, WordIndexSet & words, solveEngineT engine)
+{
+	words.clear();
+	return SearchUnique(board, lex, words, NULL, engine);
+}
+
+template <typename BoardType>
+  int SolveBoardWords(const BoardType & board, const Lexicon & lex, WordIndexSet & seen, WordArena & words,
+					  solveEngineT engine)
+{
+	seen.clear();
+	words.clear();
+	return SearchUnique(board, lex, seen, &words, engine);
+}
+
+template <typename BoardType>
+  void SolveBoardParallel(const BoardType & board, const Lexicon & lex, Set<string> & wordsSeen, Vector<string> & found,
+						  ThreadPool & pool, solveEngineT engine)
+{
+	Vector<searchT<BoardType> *> searches;
+	MakeSearches(board, lex, ResolveEngine(board, lex, engine), BoardType::NUM_CELLS > 16, searches);
+	for (int i = 0; i < searches.size(); i++) {
+		pool.submit(RunSearch<BoardType>, searches[i]);
+	}
+	pool.wait();
+	WordIndexSet indexes;
+	MergeSearches(searches, indexes);
+	AddNewWords(lex, indexes, wordsSeen, found);
+}
+
+template <typename BoardType>
+  bool FindWordPath(const BoardType & board, const string & word, int path[])
+{
+	if (word.empty() || word.length() > BoardType::NUM_CELLS) return false;
+	int counts[256] = { 0 };		// a word needing more of a letter than is showing can't be traced,
+	for (int cell = 0; cell < BoardType::NUM_CELLS; cell++)			// however the cubes are arranged
+		counts[(unsigned char)board.letterAt(cell)]++;
+	for (int i = 0; i < word.length(); i++) {
+		if (--counts[(unsigned char)toupper(word[i])] < 0) return false;
+	}
+	return TracePath(board, word, 0, -1, 0, path);
+}
+
+template <typename BoardType>
+  wordCheckT CheckWord(const BoardType & board, const Lexicon & lex, const string & word, int path[])
+{
+	if (word.length() < MIN_WORD_LENGTH) return WordTooShort;
+	if (!lex.containsWord(word)) return WordNotInLexicon;
+	if (!FindWordPath(board, word, path)) return WordNotOnBoard;
+	return WordAccepted;
+}
+
+template <typename BoardType>
+  void PruneLexiconForBoard(const BoardType & board, const Lexicon & lex, Lexicon & result)
+{
+	unsigned int follows[26] = { 0 };
+	for (int cell = 0; cell < BoardType::NUM_CELLS; cell++) {
+		char letter = tolower(board.letterAt(cell));
+		if (!LetterBit(letter)) continue;
+		for (int i = 0; i < BoardType::numNeighbors(cell); i++)
+			follows[letter - 'a'] |= LetterBit(board.letterAt(BoardType::neighbor(cell, i)));
+	}
+	lex.extractSpelledFrom(board.toString(), result, follows);
+}
+
+
+// Compiled for the board sizes in board.h (see StandardBoard).
+
+template void SolveBoardIndexes(const StandardBoard &, const Lexicon &, WordIndexSet &, solveEngineT);
+template void SolveBoardIndexes(const BigBoard &, const Lexicon &, WordIndexSet &, solveEngineT);
+template void SolveBoard(const StandardBoard &, const Lexicon &, Set<string> &, Vector<string> &, solveEngineT);
+template void SolveBoard(const BigBoard &, const Lexicon &, Set<string> &, Vector<string> &, solveEngineT);
+template int ScoreBoard(const StandardBoard &, const Lexicon &, WordIndexSet &, solveEngineT);
+template int ScoreBoard(const BigBoard &, const Lexicon &, WordIndexSet &, solveEngineT);
+template int SolveBoardWords(const StandardBoard &, const Lexicon &, WordIndexSet &, WordArena &, solveEngineT);
+template int SolveBoardWords(const BigBoard &, const Lexicon &, WordIndexSet &, WordArena &, solveEngineT);
+template void SolveBoardParallel(const StandardBoard &, const Lexicon &, Set<string> &, Vector<string> &, ThreadPool &,
+								 solveEngineT);
+template void SolveBoardParallel(const BigBoard &, const Lexicon &, Set<string> &, Vector<string> &, ThreadPool &,
+								 solveEngineT);
+template solveEngineT ChooseSolveEngine(const StandardBoard &, const Lexicon &);
+template solveEngineT ChooseSolveEngine(const BigBoard &, const Lexicon &);
+template bool FindWordPath(const StandardBoard &, const string &, int []);
+template bool FindWordPath(const BigBoard &, const string &, int []);
+template wordCheckT CheckWord(const StandardBoard &, const Lexicon &, const string &, int []);
+template wordCheckT CheckWord(const BigBoard &, const Lexicon &, const string &, int []);
+template void PruneLexiconForBoard(const StandardBoard &, const Lexicon &, Lexicon &);
+template void PruneLexiconForBoard(const BigBoard &, const Lexicon &, Lexicon &);
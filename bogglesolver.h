@@ -0,0 +1,215 @@
+/*
+ * File: bogglesolver.h
+ * --------------------
+ * Defines the functions that find words on a Boggle board. They only
+ * report what they find and make no graphics calls, so they
+ * can be used outside the interactive game. Each is a template on the
+ * board type, compiled for StandardBoard and BigBoard in bogglesolver.cpp.
+ */
+
+#ifndef _bogglesolver_h
+#define _bogglesolver_h
+
+#include "genlib.h"
+#include "board.h"
+#include "vector.h"
+#include "set.h"
+#include "lexicon.h"
+#include "threadpool.h"
+#include "wordindexset.h"
+#include "wordarena.h"
+
+
+/*
+ * Constant: MIN_WORD_LENGTH
+ * -------------------------
+ * Words shorter than this don't count.
+ */
+const int MIN_WORD_LENGTH = 4;
+
+
+/*
+ * Functions: ScoreForWord, ScoreForLength
+ * Usage: points = ScoreForWord(word);
+ * -----------------------------------
+ * These functions return the number of points a word, or a word of the
+ * given length, is worth: a 4-letter word is worth 1 point, a 5-letter
+ * word 2 points, and so on.
+ */
+inline int ScoreForLength(int length) { return length - (MIN_WORD_LENGTH - 1); }
+inline int ScoreForWord(string word) { return ScoreForLength(word.length()); }
+
+
+/*
+ * Type: solveEngineT
+ * ------------------
+ * The ways the solving functions below can search a board, given as the
+ * last argument to any of them. BoardFirstEngine walks the paths on the
+ * board and follows each one down the lexicon, stopping once no word
+ * begins with its letters. DictionaryFirstEngine walks the lexicon
+ * instead, and follows each prefix on the board, stepping every path
+ * that spells it onto the neighboring cubes showing the next letter, so
+ * the board's letters prune the lexicon rather than the other way round.
+ * The two find the same words, but board-first finds them in the order
+ * of the paths that reach them and dictionary-first in the lexicon's
+ * order. AutoEngine, the default, leaves the choice to
+ * ChooseSolveEngine. Boards with any cube that doesn't show a letter
+ * are always searched board-first.
+ */
+enum solveEngineT {
+	AutoEngine,
+	BoardFirstEngine,
+	DictionaryFirstEngine
+};
+
+
+/*
+ * Function: SolveBoard
+ * Usage: SolveBoard(board, lex, wordsSeen, found);
+ * ------------------------------------------------
+ * This function finds every word of at least MIN_WORD_LENGTH letters that
+ * can be traced on the board and is in the lexicon, skipping words already
+ * in wordsSeen. Each new word is appended once to found, in the order the
+ * search comes across it, and is added to wordsSeen.
+ */
+template <typename BoardType>
+  void SolveBoard(const BoardType & board, const Lexicon & lex, Set<string> & wordsSeen, Vector<string> & found,
+				  solveEngineT engine = AutoEngine);
+
+/*
+ * Function: SolveBoardIndexes
+ * Usage: SolveBoardIndexes(board, lex, found);
+ * --------------------------------------------
+ * This function finds the same words as SolveBoard, but as indexes in
+ * the lexicon (see Lexicon::indexOf) rather than strings. Each one not
+ * already in found is added to it, in the order the search comes across
+ * it. Use lex.wordAt to spell any of them out.
+ */
+template <typename BoardType>
+  void SolveBoardIndexes(const BoardType & board, const Lexicon & lex, WordIndexSet & found,
+						 solveEngineT engine = AutoEngine);
+
+/*
+ * Function: ScoreBoard
+ * Usage: int score = ScoreBoard(board, lex, words);
+ * -------------------------------------------------
+ * This function returns the total score of the words SolveBoard would
+ * find on the board, and leaves their indexes in words, which is cleared
+ * first. Words are scored as the search first reaches them, so nothing
+ * has to be spelled out; it is meant for programs that score a great
+ * many boards, and words can be reused from one call to the next.
+ */
+template <typename BoardType>
+  int ScoreBoard(const BoardType & board, const Lexicon & lex, WordIndexSet & words, solveEngineT engine = AutoEngine);
+
+/*
+ * Function: SolveBoardWords
+ * Usage: int score = SolveBoardWords(board, lex, seen, words);
+ * ------------------------------------------------------------
+ * This function finds the same words as SolveBoardIndexes, in the same
+ * order, and spells them into words in lower case, as Lexicon::wordAt
+ * does, returning their total score. Both seen, which ends up holding
+ * their indexes, and words are cleared first. Each word is spelled from
+ * the letters of the path that reached it, so neither the lexicon nor
+ * the heap is touched to make the strings; a caller that keeps the same
+ * seen and words for each board it solves, such as one pair per thread,
+ * soon stops allocating altogether.
+ */
+template <typename BoardType>
+  int SolveBoardWords(const BoardType & board, const Lexicon & lex, WordIndexSet & seen, WordArena & words,
+					  solveEngineT engine = AutoEngine);
+
+/*
+ * Function: SolveBoardParallel
+ * Usage: SolveBoardParallel(board, lex, wordsSeen, found, pool);
+ * --------------------------------------------------------------
+ * This function finds the same words as SolveBoard, in the same order,
+ * but spreads the search across the threads of the pool. A board-first
+ * search is split up by starting cube, and on boards larger than 4x4
+ * also by the second cube, so there are enough pieces for stealing to
+ * balance the load; a dictionary-first one is split up by the first
+ * letter of the words. Each piece collects its words separately and the pieces are
+ * merged and de-duplicated once all of them are done. The lexicon must
+ * not be changed while this function runs.
+ */
+template <typename BoardType>
+  void SolveBoardParallel(const BoardType & board, const Lexicon & lex, Set<string> & wordsSeen, Vector<string> & found,
+						  ThreadPool & pool, solveEngineT engine = AutoEngine);
+
+/*
+ * Function: ChooseSolveEngine
+ * Usage: solveEngineT engine = ChooseSolveEngine(board, lex);
+ * -----------------------------------------------------------
+ * This function returns the engine likely to search the board against
+ * the lexicon faster, which is what AutoEngine runs. It weighs how
+ * often the board's letters repeat, which sets how many paths share
+ * each prefix, against the size of the lexicon, without searching
+ * anything (see bogglesolver.cpp for the model). Boards shaken from the
+ * real cubes go board-first against the real lexicon; boards with few
+ * different letters, and small lexicons such as a themed word list,
+ * go dictionary-first.
+ */
+template <typename BoardType>
+  solveEngineT ChooseSolveEngine(const BoardType & board, const Lexicon & lex);
+
+/*
+ * Function: FindWordPath
+ * Usage: if (FindWordPath(board, word, path)) ...
+ * -----------------------------------------------
+ * This function checks whether the word can be traced on the board,
+ * each letter on a cube adjacent to the one before and no cube used
+ * twice. Letters are matched without regard to case. If it can, the
+ * function fills in path with the cells of the first such tracing it
+ * comes across, one per letter, and returns true; otherwise it returns
+ * false. path must have room for NUM_CELLS cells. Words that need more
+ * of some letter than the board shows are turned down without a search,
+ * and otherwise the search stops at the first tracing found and
+ * allocates nothing, so it is cheap enough to check words as fast as
+ * they can be submitted, even on boards with many repeated letters.
+ */
+template <typename BoardType>
+  bool FindWordPath(const BoardType & board, const string & word, int path[]);
+
+/*
+ * Type: wordCheckT
+ * ----------------
+ * The outcomes of checking a player's word with CheckWord.
+ */
+enum wordCheckT {
+	WordAccepted,
+	WordTooShort,			// fewer than MIN_WORD_LENGTH letters
+	WordNotInLexicon,
+	WordNotOnBoard			// can't be traced on the board
+};
+
+/*
+ * Function: CheckWord
+ * Usage: if (CheckWord(board, lex, word, path) == WordAccepted) ...
+ * -----------------------------------------------------------------
+ * This function applies the rules for a word a player enters: it must
+ * have at least MIN_WORD_LENGTH letters, be in the lexicon and be
+ * traceable on the board. It returns the first rule the word breaks, in
+ * that order, or WordAccepted with path filled in as by FindWordPath.
+ * Whether the word was already found is up to the caller, since only it
+ * knows which words count against whom. It only reads its arguments, so
+ * any number of threads can check words at once.
+ */
+template <typename BoardType>
+  wordCheckT CheckWord(const BoardType & board, const Lexicon & lex, const string & word, int path[]);
+
+/*
+ * Function: PruneLexiconForBoard
+ * Usage: PruneLexiconForBoard(board, lex, boardLex);
+ * --------------------------------------------------
+ * This function fills result with the words of lex that could possibly
+ * be traced on the board: those spelled from the board's letters, each
+ * used no more often than it is showing, with every pair of letters in a
+ * row showing on neighboring cubes. Solving the board
+ * against result finds exactly the words that solving it against lex
+ * does, while touching only a few thousand nodes instead of the whole
+ * dawg, so it pays off when a board is searched more than once.
+ */
+template <typename BoardType>
+  void PruneLexiconForBoard(const BoardType & board, const Lexicon & lex, Lexicon & result);
+
+#endif
@@ -0,0 +1,90 @@
+/*
+ * File: bogglestats.cpp
+ * ---------------------
+ * Implements the optional stats declared in bogglestats.h. Without
+ * BOGGLE_STATS this file compiles to nothing.
+ */
+
+#include "bogglestats.h"
+
+#ifdef BOGGLE_STATS
+
+#include <pthread.h>
+#include "walltime.h"
+#include <cstdio>		// for sprintf
+
+boggleStatsT BoggleStats;
+
+static pthread_mutex_t statsLock = PTHREAD_MUTEX_INITIALIZER;		// guards BoggleStats
+
+static const char *const PhaseNames[NUM_PHASES] = { "load", "board", "validate", "solve", "render" };
+
+
+void ResetBoggleStats()
+{
+	pthread_mutex_lock(&statsLock);
+	BoggleStats = boggleStatsT();
+	pthread_mutex_unlock(&statsLock);
+}
+
+void AddSearchStats(const searchStatsT & stats)
+{
+	pthread_mutex_lock(&statsLock);
+	BoggleStats.search.nodesExpanded += stats.nodesExpanded;
+	BoggleStats.search.childLookups += stats.childLookups;
+	BoggleStats.search.prefixChecks += stats.prefixChecks;
+	BoggleStats.search.prefixPruned += stats.prefixPruned;
+	BoggleStats.search.wordsFound += stats.wordsFound;
+	BoggleStats.numSearches++;
+	pthread_mutex_unlock(&statsLock);
+}
+
+void AddEngineChoice(bool dictionaryFirst)
+{
+	pthread_mutex_lock(&statsLock);
+	if (dictionaryFirst) BoggleStats.dictionaryFirstSolves++;
+	else BoggleStats.boardFirstSolves++;
+	pthread_mutex_unlock(&statsLock);
+}
+
+void AddPhaseTime(statsPhaseT phase, double seconds)
+{
+	pthread_mutex_lock(&statsLock);
+	BoggleStats.phaseSeconds[phase] += seconds;
+	pthread_mutex_unlock(&statsLock);
+}
+
+void PrintBoggleStats(ostream & out)
+{
+	pthread_mutex_lock(&statsLock);
+	boggleStatsT stats = BoggleStats;
+	pthread_mutex_unlock(&statsLock);
+	out << "Search: " << stats.search.nodesExpanded << " cubes visited, "
+		<< stats.search.childLookups << " child lookups, "
+		<< stats.search.prefixChecks << " prefix checks, "
+		<< stats.search.prefixPruned << " paths pruned, "
+		<< stats.search.wordsFound << " words reached, in "
+		<< stats.numSearches << " pieces" << endl;
+	out << "Engine: " << stats.boardFirstSolves << " boards searched board-first, "
+		<< stats.dictionaryFirstSolves << " dictionary-first" << endl;
+	out << "Time (ms):";
+	for (int i = 0; i < NUM_PHASES; i++) {
+		char ms[32];
+		sprintf(ms, "%.2f", stats.phaseSeconds[i] * 1000);
+		out << " " << PhaseNames[i] << " " << ms;
+	}
+	out << endl;
+}
+
+PhaseTimer::PhaseTimer(statsPhaseT phase)
+{
+	this->phase = phase;
+	start = CurrentTime();
+}
+
+PhaseTimer::~PhaseTimer()
+{
+	AddPhaseTime(phase, CurrentTime() - start);
+}
+
+#endif
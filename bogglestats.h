@@ -0,0 +1,137 @@
+/*
+ * File: bogglestats.h
+ * -------------------
+ * Defines optional counters and timers for finding out where the time
+ * goes in a game: in the search, in the lexicon or in the graphics. They
+ * are only compiled in when BOGGLE_STATS is defined, for example by
+ * building with -DBOGGLE_STATS. Otherwise the macros at the bottom of
+ * this file expand to nothing and the program is the same as if they
+ * weren't there.
+ */
+
+#ifndef _bogglestats_h
+#define _bogglestats_h
+
+#ifdef BOGGLE_STATS
+
+#include "genlib.h"
+#include <iostream>
+
+
+/*
+ * Type: statsPhaseT
+ * -----------------
+ * The parts of a game that are timed separately.
+ */
+enum statsPhaseT {
+	LoadPhase,			// reading the lexicon
+	BoardPhase,			// shaking or configuring the board
+	ValidatePhase,		// checking the words the player enters
+	SolvePhase,			// the computer's search
+	RenderPhase,		// drawing the board and the word lists
+	NUM_PHASES
+};
+
+
+/*
+ * Type: searchStatsT
+ * ------------------
+ * What the solver did. A lexicon lookup finds a child in one step (see
+ * Lexicon::findChildNode), so childLookups counts those steps as well.
+ */
+struct searchStatsT {
+	long long nodesExpanded;		// cubes the search stepped onto
+	long long childLookups;			// letters looked up among a dawg node's children
+	long long prefixChecks;			// checks for longer words under the letters so far
+	long long prefixPruned;			// paths cut off because no word, or no longer word, starts with them
+	long long wordsFound;			// words reached, counting each path to a word
+};
+
+
+/*
+ * Type: boggleStatsT
+ * ------------------
+ * Everything counted and timed since the stats were last reset.
+ */
+struct boggleStatsT {
+	searchStatsT search;
+	int numSearches;				// pieces of search merged into search
+	int boardFirstSolves;			// boards searched by each engine (see solveEngineT)
+	int dictionaryFirstSolves;
+	double phaseSeconds[NUM_PHASES];
+};
+
+
+/*
+ * Variable: BoggleStats
+ * ---------------------
+ * The stats gathered so far. Read it only on a thread that isn't also
+ * adding to it.
+ */
+extern boggleStatsT BoggleStats;
+
+
+/*
+ * Functions: ResetBoggleStats, AddSearchStats, AddEngineChoice, AddPhaseTime
+ * Usage: AddSearchStats(search.stats);
+ * ------------------------------------
+ * ResetBoggleStats sets every count and time back to zero. The others
+ * add to BoggleStats under a lock, so they may be called from any number
+ * of threads at once; AddEngineChoice counts one board searched
+ * dictionary-first or board-first.
+ */
+void ResetBoggleStats();
+void AddSearchStats(const searchStatsT & stats);
+void AddEngineChoice(bool dictionaryFirst);
+void AddPhaseTime(statsPhaseT phase, double seconds);
+
+
+/*
+ * Function: PrintBoggleStats
+ * Usage: PrintBoggleStats(cout);
+ * ------------------------------
+ * Writes a short report of BoggleStats.
+ */
+void PrintBoggleStats(ostream & out);
+
+
+/*
+ * Class: PhaseTimer
+ * -----------------
+ * A phase timer adds the time from its construction to its destruction
+ * to a phase, so a single declaration times the rest of a block.
+ */
+class PhaseTimer {
+  public:
+    PhaseTimer(statsPhaseT phase);
+    ~PhaseTimer();
+
+  private:
+    statsPhaseT phase;
+    double start;
+};
+
+
+/*
+ * Macros: STATS_ONLY, STATS_COUNT, STATS_TIME_PHASE
+ * Usage: STATS_ONLY(searchStatsT stats;)
+ *        STATS_COUNT(search.stats.wordsFound);
+ *        STATS_TIME_PHASE(SolvePhase);
+ * ----------------------------------------------
+ * STATS_ONLY keeps its argument only in stats builds. STATS_COUNT adds one
+ * to a counter, and STATS_TIME_PHASE times the rest of the enclosing block
+ * as the given phase.
+ */
+#define STATS_ONLY(code) code
+#define STATS_COUNT(counter) ((counter)++)
+#define STATS_TIME_PHASE(phase) PhaseTimer phaseTimer(phase)
+
+#else
+
+#define STATS_ONLY(code)
+#define STATS_COUNT(counter) ((void)0)
+#define STATS_TIME_PHASE(phase) ((void)0)
+
+#endif
+
+#endif
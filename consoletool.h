@@ -0,0 +1,18 @@
+/*
+ * File: consoletool.h
+ * -------------------
+ * Included by the command-line tools, which have no graphics window.
+ * genlib.h renames main so the graphics library can supply its own and
+ * call the program's as Main; a tool doesn't use the graphics library,
+ * so this header undoes the renaming and the tool keeps the real main.
+ * Include it after genlib.h, or instead of it.
+ */
+
+#ifndef _consoletool_h
+#define _consoletool_h
+
+#include "genlib.h"
+
+#undef main
+
+#endif
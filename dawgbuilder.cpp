@@ -0,0 +1,200 @@
+/*
+ * File: dawgbuilder.cpp
+ * ---------------------
+ * Implements the DawgBuilder class.
+ *
+ * The words are sorted and then fed one at a time into a trie that is
+ * minimized as it grows, following Daciuk et al., "Incremental
+ * Construction of Minimal Acyclic Finite-State Automata" (Computational
+ * Linguistics, 2000). Once the next word has moved past a node, nothing
+ * below that node can change any more, so it is compared against a
+ * register of the nodes already finished and replaced by an equivalent
+ * one if there is one. Two nodes are equivalent if both or neither end a
+ * word and they have the same edges to the same (already minimized)
+ * children. When every word has been added, each distinct run of child
+ * edges is laid out once in the edge array.
+ */
+
+#include "dawgbuilder.h"
+#include <algorithm>	// for sort, unique
+#include <map>
+#include <cstdio>		// for sprintf
+#include <cctype>		// for tolower
+
+
+/* Struct: nodeT
+ * -------------
+ * A node of the graph under construction. Its edges are kept in
+ * alphabetical order, which is the order words arrive in.
+ */
+
+struct nodeT {
+	bool accept;						// a word ends here
+	std::vector<char> letters;			// letter on each edge, as 1 to 26
+	std::vector<int> children;			// node at the far end of each edge
+};
+
+// Describes a node's edges as a string, for use as a register key.
+// Edges alone identify a run of siblings in the output; with the accept
+// flag in front they identify an equivalence class of nodes.
+static string EdgesKey(const nodeT & node)
+{
+	string key;
+	char buf[16];
+	for (int i = 0; i < node.letters.size(); i++) {
+		sprintf(buf, "%c%d,", 'a' + node.letters[i] - 1, node.children[i]);
+		key += buf;
+	}
+	return key;
+}
+
+static string NodeKey(const nodeT & node)
+{
+	return (node.accept ? "+" : "-") + EdgesKey(node);
+}
+
+
+DawgBuilder::DawgBuilder()
+{
+	sorted = true;
+}
+
+bool DawgBuilder::canHold(const string & word)
+{
+	if (word.empty()) return false;
+	for (int i = 0; i < word.length(); i++) {
+		char ch = tolower(word[i]);
+		if (ch < 'a' || ch > 'z') return false;
+	}
+	return true;
+}
+
+bool DawgBuilder::add(string word)
+{
+	if (!canHold(word)) return false;
+	for (int i = 0; i < word.length(); i++)
+		word[i] = tolower(word[i]);
+	if (sorted && !words.empty() && word <= words.back())
+		sorted = false;			// out of order, or a repeat
+	words.push_back(word);
+	return true;
+}
+
+int DawgBuilder::numWords()
+{
+	sortWords();
+	return words.size();
+}
+
+void DawgBuilder::sortWords()
+{
+	if (sorted) return;
+	std::sort(words.begin(), words.end());
+	words.erase(std::unique(words.begin(), words.end()), words.end());
+	sorted = true;
+}
+
+
+/* Helper class: Minimizer
+ * -----------------------
+ * Holds the state of one run of the incremental construction: the nodes
+ * made so far, the register of finished nodes, and the path of unfinished
+ * nodes along the last word added.
+ */
+
+class Minimizer {
+  public:
+	std::vector<nodeT> nodes;					// node 0 is the root
+	std::vector<int> path;						// unfinished nodes, path[0] is the root
+
+	Minimizer() { nodes.push_back(nodeT()); nodes[0].accept = false; path.push_back(0); }
+
+	void addWord(const string & word, const string & previous);
+	void finishDownTo(int length);
+
+  private:
+	std::map<string, int> finished;			// NodeKey of each finished node
+};
+
+// Replaces the nodes on the unfinished path deeper than the given length
+// with their registered equivalents, deepest first.
+void Minimizer::finishDownTo(int length)
+{
+	while (path.size() > length + 1) {
+		int node = path.back();
+		path.pop_back();
+		nodeT & parent = nodes[path.back()];
+		string key = NodeKey(nodes[node]);
+		std::map<string, int>::iterator found = finished.find(key);
+		if (found != finished.end()) {
+			parent.children.back() = found->second;		// the node is redundant; it's left unreferenced
+		} else {
+			finished[key] = node;
+		}
+	}
+}
+
+void Minimizer::addWord(const string & word, const string & previous)
+{
+	int common = 0;
+	while (common < word.length() && common < previous.length() && word[common] == previous[common])
+		common++;
+	finishDownTo(common);
+	for (int i = common; i < word.length(); i++) {
+		nodeT child;
+		child.accept = false;
+		nodes.push_back(child);					// may move the nodes, so look the parent up afterwards
+		nodes[path.back()].letters.push_back(word[i] - 'a' + 1);
+		nodes[path.back()].children.push_back(nodes.size() - 1);
+		path.push_back(nodes.size() - 1);
+	}
+	nodes[path.back()].accept = true;
+}
+
+
+// Each node with children gets a run of edges, and nodes with the same
+// edges share one run. Runs are numbered in the order they are first
+// reached going depth-first from the root, children before their parents'
+// later siblings, which keeps related edges near each other.
+static int LayOutRun(std::vector<nodeT> & nodes, int node, std::vector<int> & runFor,
+					 std::map<string, int> & runs, std::vector<unsigned int> & edges)
+{
+	if (nodes[node].letters.empty()) return 0;
+	if (runFor[node] != -1) return runFor[node];
+	string key = EdgesKey(nodes[node]);
+	std::map<string, int>::iterator found = runs.find(key);
+	if (found != runs.end()) return runFor[node] = found->second;
+
+	int first = edges.size();
+	int count = nodes[node].letters.size();
+	runs[key] = runFor[node] = first;
+	edges.resize(first + count);
+	for (int i = 0; i < count; i++) {
+		int child = nodes[node].children[i];
+		unsigned int childRun = LayOutRun(nodes, child, runFor, runs, edges);
+		if (childRun >= (1u << 24))
+			Error("DawgBuilder: too many edges for the dawg format");
+		edges[first + i] = (childRun << 8) | ((nodes[child].accept ? 1u : 0u) << 6)
+						 | ((i == count - 1 ? 1u : 0u) << 5) | (unsigned int)nodes[node].letters[i];
+	}
+	return first;
+}
+
+int DawgBuilder::build(std::vector<unsigned int> & edges)
+{
+	sortWords();
+	Minimizer m;
+	string previous;
+	for (int i = 0; i < words.size(); i++) {
+		m.addWord(words[i], previous);
+		previous = words[i];
+	}
+	m.finishDownTo(0);
+
+	edges.clear();
+	edges.push_back(0);		// placeholder edge 0, since index 0 means no children
+	std::vector<int> runFor(m.nodes.size(), -1);
+	std::map<string, int> runs;
+	int start = LayOutRun(m.nodes, 0, runFor, runs, edges);
+	return start;
+}
@@ -0,0 +1,98 @@
+/*
+ * File: dawgbuilder.h
+ * -------------------
+ * Defines the DawgBuilder class, which compiles a list of words into the
+ * minimal dawg (directed acyclic word graph) used by the Lexicon class.
+ */
+
+#ifndef _dawgbuilder_h
+#define _dawgbuilder_h
+
+#include "genlib.h"
+#include <vector>
+
+
+/*
+ * Class: DawgBuilder
+ * ------------------
+ * A builder collects words, in any order and with repeats, and then
+ * compiles them into an array of edges in the layout described at the top
+ * of lexicon.cpp. Equivalent suffixes anywhere in the word list share one
+ * copy, and so do identical runs of sibling edges, so the result is as
+ * small as this layout allows. Most clients don't use the builder
+ * directly; Lexicon::compact and Lexicon::writeBinaryFile use it to turn
+ * any lexicon into a dawg. Sample use:
+ *
+ *	DawgBuilder builder;
+ *	builder.add("rat");
+ *	builder.add("cat");
+ *	std::vector<unsigned int> edges;
+ *	int start = builder.build(edges);
+ */
+
+class DawgBuilder {
+
+  public:
+
+   /*
+    * Constructor: DawgBuilder
+    * Usage: DawgBuilder builder;
+    * ---------------------------
+    * The constructor makes a builder holding no words.
+    */
+    DawgBuilder();
+
+   /*
+    * Member function: add
+    * Usage: if (!builder.add(word))...
+    * ---------------------------------
+    * This member function adds a word to be compiled, case-insensitively.
+    * The dawg can only hold the letters a to z, so a word containing any
+    * other character (or no characters at all) is rejected and false is
+    * returned.
+    */
+    bool add(string word);
+
+   /*
+    * Member function: canHold
+    * Usage: if (DawgBuilder::canHold(word))...
+    * -----------------------------------------
+    * This static member function returns true if add would take the
+    * word, that is, if it is made only of the letters a to z in either
+    * case and isn't empty.
+    */
+    static bool canHold(const string & word);
+
+   /*
+    * Member function: build
+    * Usage: int start = builder.build(edges);
+    * ----------------------------------------
+    * This member function compiles the words added so far. It fills edges
+    * with one 32-bit value per edge, packed as
+    *
+    *	children << 8 | accept << 6 | lastEdge << 5 | letter
+    *
+    * which is the order the fields have on disk, and returns the index of
+    * the first edge leaving the start node, or 0 if there are no words.
+    * Edge 0 is a placeholder, since a children index of 0 means the edge
+    * has none.
+    */
+    int build(std::vector<unsigned int> & edges);
+
+   /*
+    * Member function: numWords
+    * Usage: n = builder.numWords();
+    * ------------------------------
+    * This member function returns the number of different words the
+    * builder holds.
+    */
+    int numWords();
+
+  private:
+    std::vector<string> words;
+    bool sorted;		// whether words is known to be sorted with no repeats
+
+    void sortWords();
+};
+
+#endif
@@ -14,11 +14,17 @@
  * and many of the helper functions do not require individual comments. 
  * For descriptions of the behavior of the exported functions, 
  * please see the interface file.
+ *
+ * The graphics library may only be used from one thread, so flashed
+ * cubes are not un-highlighted by a timer. Instead the time each cube
+ * is due to go back to normal is kept in gState, and every exported
+ * function starts by putting back the cubes whose time is up.
  */
 
 #include "extgraph.h"
 #include "gboggle.h"
 #include "strutils.h"	// for IntegerToString, ConvertToLowerCase
+#include "walltime.h"	// for CurrentTime
 
 
 /* Constants
@@ -45,7 +51,9 @@ const int WORD_FONT_SIZE = 10;
  * (to place additional words in the correct location in the displayed word list)
  * and the scores for each player (which must be saved and erased before updating).
  * There is also a 2-d array of the letters currently showing on the
- * cubes, to enable drawing them inverted for the highlighting function.
+ * cubes, to enable drawing them inverted for the highlighting function,
+ * and another of the times at which flashed cubes are due to be
+ * un-highlighted.
  */
  
 struct rectT { double x, y, w, h; };
@@ -60,6 +68,7 @@ static struct {
 	rectT board;			// rectangle enscribed the cubes w/ border
 	int numRows, numCols;	// dimensions of cube layout on board
 	char letters[MAX_DIMENSION][MAX_DIMENSION];
+	double flashEnds[MAX_DIMENSION][MAX_DIMENSION];	// 0 if the cube isn't flashing
 } gState;
 
 
@@ -84,8 +93,11 @@ static void DrawPlayerLabel(playerT player, string name);
 static void DrawEmptyCubes();
 static void DrawOneScore(playerT playerNum, int value);
 static void AddToScoreForPlayer(int pointsToAdd, playerT playerNum);
+static bool DrawWordInList(string word, playerT player);
 static void InitColors();
 static void CalculateGeometry(int numRows, int numCols);
+static void EndExpiredFlashes();
+static bool EndDueFlashes(double now);
 
 
 /* 
@@ -100,6 +112,9 @@ void DrawBoard(int numRows, int numCols)
 	if (numRows < 0 || numRows > MAX_DIMENSION || numCols < 0 || numCols > MAX_DIMENSION)
 		Error("DrawBoard called with invalid dimensions.");
 		
+	for (int row = 0; row < MAX_DIMENSION; row++)
+		for (int col = 0; col < MAX_DIMENSION; col++)
+			gState.flashEnds[row][col] = 0;
 	SetWindowTitle("Welcome to Boggle!");
 	InitColors();
 	CalculateGeometry(numRows, numCols);
@@ -122,9 +137,11 @@ void DrawBoard(int numRows, int numCols)
  */ 
 void LabelCube(int row, int col, char letter)
 {
+	EndExpiredFlashes();
 	if (row < 0 || row >= gState.numRows || col < 0 || col >= gState.numCols)
 		Error("LabelCube called with invalid row, col arguments.");
 	gState.letters[row][col] = letter;
+	gState.flashEnds[row][col] = 0;
 	DrawCube(row, col, letter, false);
 }
 
@@ -137,12 +154,79 @@ void LabelCube(int row, int col, char letter)
  */ 
 void HighlightCube(int row, int col, bool flag)
 {
+	EndExpiredFlashes();
 	if (row < 0 || row >= gState.numRows || col < 0 || col >= gState.numCols)
 		Error("LabelCube called with invalid row, col arguments.");
+	gState.flashEnds[row][col] = 0;
 	DrawCube(row, col, gState.letters[row][col], flag);
 }
 
 
+/* 
+ * Function: FlashCube
+ * -------------------
+ * Exported function used to highlight a cube for a while without
+ * waiting.  The cube is drawn highlighted now and its deadline recorded,
+ * for a later call to put it back once the deadline has passed.
+ */ 
+void FlashCube(int row, int col, double seconds)
+{
+	EndExpiredFlashes();
+	if (row < 0 || row >= gState.numRows || col < 0 || col >= gState.numCols)
+		Error("FlashCube called with invalid row, col arguments.");
+	double end = CurrentTime() + seconds;
+	if (end > gState.flashEnds[row][col]) gState.flashEnds[row][col] = end;
+	DrawCube(row, col, gState.letters[row][col], true);
+}
+
+
+/* 
+ * Function: EndFlashes
+ * --------------------
+ * Exported function to un-highlight all of the flashing cubes at once,
+ * which it does by treating every deadline as already past.
+ */ 
+void EndFlashes()
+{
+	if (EndDueFlashes(-1)) UpdateDisplay();
+}
+
+
+/* 
+ * Function: EndDueFlashes
+ * -----------------------
+ * Un-highlights each flashing cube whose deadline is no later than now,
+ * or every one if now is negative, and returns whether any were.
+ */ 
+static bool EndDueFlashes(double now)
+{
+	bool any = false;
+	for (int row = 0; row < gState.numRows; row++) {
+		for (int col = 0; col < gState.numCols; col++) {
+			double end = gState.flashEnds[row][col];
+			if (end != 0 && (now < 0 || end <= now)) {
+				gState.flashEnds[row][col] = 0;
+				DrawCube(row, col, gState.letters[row][col], false);
+				any = true;
+			}
+		}
+	}
+	return any;
+}
+
+
+/* 
+ * Function: EndExpiredFlashes
+ * ---------------------------
+ * Called first thing by the exported functions to put back the cubes
+ * whose flash has run out since the last call.  The display is updated
+ * only if there were some, since most calls find none.
+ */ 
+static void EndExpiredFlashes()
+{
+	if (EndDueFlashes(CurrentTime())) UpdateDisplay();
+}
+
 
 /* 
  * Function: DrawEmptyCubes
@@ -243,6 +327,27 @@ static void AddToScoreForPlayer(int pointsToAdd, playerT playerNum)
 }
 
 
+/* 
+ * Function: DrawWordInList
+ * ------------------------
+ * Draws a word in the next free spot of a player's list, which is
+ * filled in rows and columns from left to right, top to bottom, and
+ * returns whether it completed a row.  The font and pen color must
+ * already be set for the word list.
+ */
+static bool DrawWordInList(string word, playerT player)
+{
+	int numWordsInRow = gState.scoreBox[player].w/gState.wordColumnWidth;
+	int row = gState.numWords[player] / numWordsInRow;
+	int col = gState.numWords[player] % numWordsInRow;
+   	MovePen(gState.scoreBox[player].x + col*gState.wordColumnWidth, 
+   			gState.scoreBox[player].y -(row+1)*GetFontHeight());
+    DrawTextString(ConvertToLowerCase(word));
+    gState.numWords[player]++;
+    return col == numWordsInRow - 1;
+}
+
+
 /* 
  * Function: RecordWordForPlayer
  * -----------------------------
@@ -254,21 +359,42 @@ static void AddToScoreForPlayer(int pointsToAdd, playerT playerNum)
  */
 void RecordWordForPlayer(string word, playerT player)
 {
+	EndExpiredFlashes();
 	if (player != Human && player != Computer)
 		Error("RecordWordForPlayer called with invalid player argument.");
-	word = ConvertToLowerCase(word);
     SetFont(WORD_FONT);
 	SetPointSize(WORD_FONT_SIZE);
 	SetPenColor("Word Color");
-	int numWordsInRow = gState.scoreBox[player].w/gState.wordColumnWidth;
-	int row = gState.numWords[player] / numWordsInRow;
-	int col = gState.numWords[player] % numWordsInRow;
-   	MovePen(gState.scoreBox[player].x + col*gState.wordColumnWidth, 
-   			gState.scoreBox[player].y -(row+1)*GetFontHeight());
-    DrawTextString(word);
-    gState.numWords[player]++;
+	bool endOfRow = DrawWordInList(word, player);
     AddToScoreForPlayer(word.length() - 3, player); // +1 pt for each letter over length 4
-    if (col == numWordsInRow -1) UpdateDisplay(); // force update when completing a row
+    if (endOfRow) UpdateDisplay(); // force update when completing a row
+}
+
+
+/* 
+ * Function: RecordWordsForPlayer
+ * ------------------------------
+ * Exported function to add a whole list of words at once.  The words
+ * are laid out just as RecordWordForPlayer would, but the font is set
+ * up once, the score is redrawn once with the total, and the display
+ * is updated once at the end, which is much quicker for a long list.
+ */
+void RecordWordsForPlayer(Vector<string> & words, playerT player)
+{
+	EndExpiredFlashes();
+	if (player != Human && player != Computer)
+		Error("RecordWordsForPlayer called with invalid player argument.");
+	if (words.isEmpty()) return;
+    SetFont(WORD_FONT);
+	SetPointSize(WORD_FONT_SIZE);
+	SetPenColor("Word Color");
+	int points = 0;
+	for (int i = 0; i < words.size(); i++) {
+		DrawWordInList(words[i], player);
+		points += words[i].length() - 3;
+	}
+    AddToScoreForPlayer(points, player);
+    UpdateDisplay();
 }
 
 
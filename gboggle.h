@@ -13,6 +13,7 @@
 #define _gboggle_h
 
 #include "genlib.h"
+#include "vector.h"
 
 /*
  * Type: playerT
@@ -75,6 +76,33 @@ void LabelCube(int row, int col, char letter);
 void HighlightCube(int row, int col, bool flag);
 
 
+/*
+ * Function: FlashCube
+ * Usage: FlashCube(row, col, seconds);
+ * ------------------------------------
+ * This function highlights the specified cube and returns right
+ * away. Once the given number of seconds has passed, the highlight
+ * is removed by the next call to any of the functions in this
+ * interface, or by EndFlashes. Nothing is drawn in the meantime, so
+ * a program waiting for input leaves the cube lit. Flashing a cube
+ * that is already flashing keeps it lit until the later of the two
+ * times, and calling HighlightCube or LabelCube on it cancels the
+ * flash. An error is raised if row or col is out of range for this
+ * boggle board.
+ */
+void FlashCube(int row, int col, double seconds);
+
+
+/*
+ * Function: EndFlashes
+ * Usage: EndFlashes();
+ * --------------------
+ * This function removes the highlight from every cube that is
+ * still flashing, without waiting for their time to be up.
+ */
+void EndFlashes();
+
+
 /*
  * Function: RecordWordForPlayer
  * Usage: RecordWordForPlayer(word, player);
@@ -89,4 +117,18 @@ void HighlightCube(int row, int col, bool flag);
 void RecordWordForPlayer(string word, playerT player);
 
 
+/*
+ * Function: RecordWordsForPlayer
+ * Usage: RecordWordsForPlayer(words, player);
+ * -------------------------------------------
+ * This function records each of the words in the list for the
+ * player, in order, with the same layout and scoring as calling
+ * RecordWordForPlayer on each one. The scoreboard and the screen
+ * are only updated once, after all the words are drawn, so use
+ * this to show a long list such as the computer's. An error is
+ * raised if player is not a valid value for playerT.
+ */
+void RecordWordsForPlayer(Vector<string> & words, playerT player);
+
+
 #endif
@@ -0,0 +1,154 @@
+/*
+ * File: incrementalsolver.cpp
+ * ---------------------------
+ * Implements the IncrementalSolver class template. Every path the
+ * search finds through the changed cells is found from the first changed
+ * cell on it, so none is added twice: the cells before that one are all
+ * unchanged and are traced backward from it, and the rest of the path is
+ * traced forward, with a lexicon cursor as in the usual solver.
+ */
+
+#include "incrementalsolver.h"
+#include "bogglesolver.h"
+
+
+template <typename BoardType>
+  IncrementalSolver<BoardType>::IncrementalSolver(const Lexicon & lex, const Lexicon & reversed)
+{
+	this->lex = &lex;
+	this->reversed = &reversed;
+	haveBoard = false;
+	canUndo = false;
+	pathCounts.resize(lex.size(), 0);
+	totalScore = totalWords = 0;
+}
+
+template <typename BoardType>
+  int IncrementalSolver<BoardType>::update(const BoardType & newBoard)
+{
+	changed = 0;
+	for (int cell = 0; cell < BoardType::NUM_CELLS; cell++) {
+		if (!haveBoard || newBoard.letterAt(cell) != board.letterAt(cell))
+			changed = CellSetAdd(changed, cell);
+	}
+	oldBoard = board;
+	board = newBoard;
+	haveBoard = canUndo = true;
+	removed.clear();
+
+	int kept = 0;
+	for (int i = 0; i < paths.size(); i++) {
+		if (paths[i].cells & changed) {
+			removed.push_back(paths[i]);
+			dropPath(paths[i]);
+		} else {
+			paths[kept++] = paths[i];
+		}
+	}
+	paths.resize(kept);
+	firstAdded = kept;
+	if (changed == 0) return totalScore;
+
+	for (int cell = 0; cell < BoardType::NUM_CELLS; cell++) {
+		if (CellSetContains(changed, cell)) {
+			Lexicon::Cursor backward = reversed->cursor();
+			int cells[BoardType::NUM_CELLS] = { cell };
+			if (backward.advance(board.letterAt(cell)))
+				addPathsBack(cells, 1, backward, CellSetAdd(0, cell));
+		}
+	}
+	return totalScore;
+}
+
+template <typename BoardType>
+  void IncrementalSolver<BoardType>::undo()
+{
+	if (!canUndo)
+		Error("IncrementalSolver::undo called with nothing to undo");
+	for (int i = firstAdded; i < paths.size(); i++)
+		dropPath(paths[i]);
+	paths.resize(firstAdded);
+	for (int i = 0; i < removed.size(); i++)
+		addPath(removed[i]);
+	board = oldBoard;
+	canUndo = false;
+}
+
+template <typename BoardType>
+  void IncrementalSolver<BoardType>::getWords(WordIndexSet & words)
+{
+	words.clear();
+	for (int i = 0; i < paths.size(); i++)
+		words.add(paths[i].word);
+}
+
+template <typename BoardType>
+  void IncrementalSolver<BoardType>::dropPath(const pathT & path)
+{
+	if (--pathCounts[path.word] == 0) {
+		totalScore -= path.points;
+		totalWords--;
+	}
+}
+
+template <typename BoardType>
+  void IncrementalSolver<BoardType>::addPath(const pathT & path)
+{
+	paths.push_back(path);
+	if (pathCounts[path.word]++ == 0) {
+		totalScore += path.points;
+		totalWords++;
+	}
+}
+
+// Finds the paths whose first changed cell is cells[0] and which begin
+// with the cells listed, which run backward from there. backward has
+// read their letters in that order, so it is on a word's prefix spelled
+// backward just when the cells, taken the other way round, begin a word;
+// then the paths going on from cells[0] are added. Either way, the cells
+// can be extended backward to another unchanged cell while backward
+// shows that its letter comes before them in some word.
+template <typename BoardType>
+  void IncrementalSolver<BoardType>::addPathsBack(int cells[], int numCells, Lexicon::Cursor backward, cellSetT visited)
+{
+	if (backward.isWord()) {
+		Lexicon::Cursor cursor = lex->cursor();
+		for (int i = numCells - 1; i > 0; i--)
+			cursor.advance(board.letterAt(cells[i]));
+		addPathsFrom(cells[0], cursor, visited);
+	}
+	cellSetT candidates = BoardType::neighborMask(cells[numCells - 1]) & ~visited & ~changed
+						  & board.cellsWithLetters(backward.nextLetters());
+	for (; candidates != 0; candidates &= candidates - 1) {
+		int prev = CellSetFirst(candidates);
+		Lexicon::Cursor longer = backward;
+		longer.advance(board.letterAt(prev));
+		cells[numCells] = prev;
+		addPathsBack(cells, numCells + 1, longer, CellSetAdd(visited, prev));
+	}
+}
+
+// Adds the paths that start with the path traced so far and continue
+// through cell, just as FindAllWords in bogglesolver.cpp finds them.
+template <typename BoardType>
+  void IncrementalSolver<BoardType>::addPathsFrom(int cell, Lexicon::Cursor cursor, cellSetT visited)
+{
+	visited = CellSetAdd(visited, cell);
+	if (!cursor.advance(board.letterAt(cell))) return;
+	if (cursor.length() >= MIN_WORD_LENGTH) {
+		int index = cursor.wordIndex();
+		if (index != -1) {
+			pathT path = { index, ScoreForLength(cursor.length()), visited };
+			addPath(path);
+		}
+	}
+	cellSetT candidates = BoardType::neighborMask(cell) & ~visited & board.cellsWithLetters(cursor.nextLetters());
+	for (; candidates != 0; candidates &= candidates - 1) {
+		addPathsFrom(CellSetFirst(candidates), cursor, visited);
+	}
+}
+
+// Compiled for the board sizes in board.h (see StandardBoard).
+
+template class IncrementalSolver<StandardBoard>;
+template class IncrementalSolver<BigBoard>;
@@ -0,0 +1,131 @@
+/*
+ * File: incrementalsolver.h
+ * -------------------------
+ * Defines the IncrementalSolver class template, which keeps the words
+ * found on a board up to date as its cubes change, for programs that
+ * look at a long series of boards that each differ from the last in
+ * only a cell or two.
+ */
+
+#ifndef _incrementalsolver_h
+#define _incrementalsolver_h
+
+#include "genlib.h"
+#include "board.h"
+#include "lexicon.h"
+#include "wordindexset.h"
+#include <vector>
+
+
+/*
+ * Class: IncrementalSolver
+ * ------------------------
+ * A solver remembers every path on its board that spells a word, along
+ * with the cells the path uses. When it is given a new board, it finds
+ * the cells that differ from the old one, drops just the paths that use
+ * any of them, and searches the new board only for paths through those
+ * cells; every other path spells what it did before. To find the new
+ * paths without walking the rest of the board, the search starts at each
+ * changed cell and first works backward over unchanged cells, checking
+ * the letters against the lexicon's prefixes spelled backward (see
+ * Lexicon::extractReversedPrefixes), then goes forward from the changed
+ * cell as the usual solver does. So a one-cube change only looks at the
+ * paths through that cube, a small part of what a full solve does. The
+ * words found, and the score, are always the same as ScoreBoard's for the
+ * current board. Sample use:
+ *
+ *	Lexicon reversed;
+ *	lex.extractReversedPrefixes(reversed);
+ *	IncrementalSolver<BigBoard> solver(lex, reversed);
+ *	int score = solver.update(board);
+ *	board.setLetterAt(cell, 'E');
+ *	if (solver.update(board) < score)
+ *		solver.undo();
+ *
+ * Making the backward lexicon takes about as long as a few thousand full
+ * solves, so it is made by the client, once, and any number of solvers
+ * can share it, each on its own thread. Neither lexicon may change for
+ * as long as a solver uses it. The template is compiled for
+ * StandardBoard and BigBoard in incrementalsolver.cpp.
+ */
+
+template <typename BoardType>
+  class IncrementalSolver {
+
+  public:
+
+   /*
+    * Constructor: IncrementalSolver
+    * Usage: IncrementalSolver<StandardBoard> solver(lex, reversed);
+    * --------------------------------------------------------------
+    * The constructor makes a solver for the words of lex, with no board
+    * yet, so its first update is a full solve. reversed must have been
+    * filled in by lex.extractReversedPrefixes.
+    */
+    IncrementalSolver(const Lexicon & lex, const Lexicon & reversed);
+
+   /*
+    * Member function: update
+    * Usage: int score = solver.update(board);
+    * ----------------------------------------
+    * This member function makes board the solver's board and returns its
+    * score, doing only the work the cells that changed call for.
+    */
+    int update(const BoardType & board);
+
+   /*
+    * Member function: undo
+    * Usage: solver.undo();
+    * ---------------------
+    * This member function puts the solver back the way it was before the
+    * last update, without searching, for a caller that tries a board and
+    * decides against it. Calling it twice in a row, or before any
+    * update, is an error.
+    */
+    void undo();
+
+   /*
+    * Member functions: score, numWords, getWords
+    * Usage: int score = solver.score();
+    *        solver.getWords(words);
+    * ----------------------------------
+    * These member functions return the score of the current board, and the
+    * number of different words on it, and fill words, clearing it first,
+    * with their indexes in the lexicon.
+    */
+    int score() const { return totalScore; }
+    int numWords() const { return totalWords; }
+    void getWords(WordIndexSet & words);
+
+  private:
+
+    // A path that spells a word, and the cells it uses.
+    struct pathT {
+        int word;
+        int points;
+        cellSetT cells;
+    };
+
+    const Lexicon *lex;
+    const Lexicon *reversed;		// every prefix of a word in lex, spelled backward
+    BoardType board;
+    bool haveBoard;
+    std::vector<pathT> paths;
+    std::vector<int> pathCounts;	// for each word index, the paths in paths that spell it
+    int totalScore, totalWords;
+
+    // What the last update did, for undo.
+    BoardType oldBoard;
+    bool canUndo;
+    int firstAdded;					// the paths from here on were added
+    std::vector<pathT> removed;
+
+    cellSetT changed;				// the cells the last update found different
+
+    void dropPath(const pathT & path);
+    void addPath(const pathT & path);
+    void addPathsBack(int cells[], int numCells, Lexicon::Cursor backward, cellSetT visited);
+    void addPathsFrom(int cell, Lexicon::Cursor cursor, cellSetT visited);
+};
+
+#endif
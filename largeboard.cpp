@@ -0,0 +1,135 @@
+/*
+ * File: largeboard.cpp
+ * --------------------
+ * Implements LargeBoard and the solver for it. The search is the one in
+ * bogglesolver.cpp, a depth-first walk carrying a lexicon cursor, with
+ * the board's cell sets replaced by a look at the eight neighbors and
+ * the mask of visited cells by a grid of flags for the tile's region.
+ */
+
+#include "largeboard.h"
+#include "board.h"
+#include "bogglesolver.h"
+#include "wordindexset.h"
+#include <algorithm>
+#include <pthread.h>
+
+
+void LargeBoard::roll(FastRandom & rng)
+{
+	for (int cell = 0; cell < numCells(); cell++) {
+		int cube = rng.nextInt(0, BigBoard::NUM_CELLS - 1);
+		letters[cell] = BigBoard::cubeFace(cube, rng.nextInt(0, BigBoard::numFaces() - 1));
+	}
+}
+
+
+/* Struct: tileSearchT
+ * -------------------
+ * One tile's search. The region is the tile and its halo, clipped to the
+ * board; visited has a flag for each of its cells.
+ */
+
+struct tileSearchT {
+	const LargeBoard *board;
+	const Lexicon *lex;
+	int maxLength;					// of any word in the lexicon
+	tileWordsT tile;
+	tileWordsFnT fn;
+	void *data;
+	pthread_mutex_t *fnLock;		// held while fn runs
+	int regionRow, regionCol, regionCols;
+	std::vector<unsigned char> visited;
+	WordIndexSet found;
+};
+
+// Finds the words that start with the path traced so far and continue
+// through the cell at row, col. A path can only step beyond the tile's
+// halo once it is longer than any word, by which time the cursor has no
+// letters left to take, so every cell looked at is in the region.
+static void FindLargeWords(tileSearchT & search, int row, int col, Lexicon::Cursor cursor)
+{
+	const LargeBoard & board = *search.board;
+	if (!cursor.advance(board.letterAt(board.cellAt(row, col)))) return;
+	if (cursor.length() >= MIN_WORD_LENGTH) {
+		int index = cursor.wordIndex();
+		if (index != -1 && search.found.add(index)) search.tile.words.push_back(index);
+	}
+	unsigned int nextLetters = cursor.nextLetters();
+	if (nextLetters == 0) return;
+	unsigned char & here = search.visited[(row - search.regionRow) * search.regionCols + col - search.regionCol];
+	here = true;
+	for (int r = row - 1; r <= row + 1; r++) {
+		if (r < 0 || r >= board.numRows()) continue;
+		for (int c = col - 1; c <= col + 1; c++) {
+			if (c < 0 || c >= board.numCols()) continue;
+			unsigned int ord = board.letterAt(board.cellAt(r, c)) - 'A';
+			if (ord >= 26 || !(nextLetters & (1u << ord))) continue;
+			if (search.visited[(r - search.regionRow) * search.regionCols + c - search.regionCol]) continue;
+			FindLargeWords(search, r, c, cursor);
+		}
+	}
+	here = false;
+}
+
+static void SearchTile(void *data, int worker)
+{
+	tileSearchT & search = *(tileSearchT *)data;
+	const LargeBoard & board = *search.board;
+	tileWordsT & tile = search.tile;
+	int halo = search.maxLength - 1;
+	search.regionRow = std::max(tile.firstRow - halo, 0);
+	search.regionCol = std::max(tile.firstCol - halo, 0);
+	int regionRows = std::min(tile.firstRow + tile.numRows + halo, board.numRows()) - search.regionRow;
+	search.regionCols = std::min(tile.firstCol + tile.numCols + halo, board.numCols()) - search.regionCol;
+	search.visited.assign((size_t)regionRows * search.regionCols, false);
+	for (int row = tile.firstRow; row < tile.firstRow + tile.numRows; row++) {
+		for (int col = tile.firstCol; col < tile.firstCol + tile.numCols; col++)
+			FindLargeWords(search, row, col, search.lex->cursor());
+	}
+	pthread_mutex_lock(search.fnLock);
+	search.fn(tile, search.data);
+	pthread_mutex_unlock(search.fnLock);
+	std::vector<int>().swap(tile.words);		// the tile is done with, so give its memory back
+	std::vector<unsigned char>().swap(search.visited);
+	search.found = WordIndexSet();
+}
+
+// Keeps the length of the longest word a visitor is shown.
+struct longestWordT {
+	int length;
+	void operator()(const string & word) { length = std::max(length, (int)word.length()); }
+};
+
+void SolveLargeBoard(const LargeBoard & board, const Lexicon & lex, ThreadPool & pool, tileWordsFnT fn, void *data,
+					 int tileSize)
+{
+	if (tileSize <= 0)
+		Error("SolveLargeBoard needs tiles at least one cell on a side");
+	longestWordT longest = { 0 };
+	longest = lex.visitWords(longest);
+	if (longest.length == 0) return;
+	pthread_mutex_t fnLock;
+	pthread_mutex_init(&fnLock, NULL);
+	std::vector<tileSearchT> searches;
+	for (int row = 0; row < board.numRows(); row += tileSize) {
+		for (int col = 0; col < board.numCols(); col += tileSize) {
+			tileSearchT search;
+			search.board = &board;
+			search.lex = &lex;
+			search.maxLength = longest.length;
+			search.tile.firstRow = row;
+			search.tile.firstCol = col;
+			search.tile.numRows = std::min(tileSize, board.numRows() - row);
+			search.tile.numCols = std::min(tileSize, board.numCols() - col);
+			search.fn = fn;
+			search.data = data;
+			search.fnLock = &fnLock;
+			searches.push_back(search);
+		}
+	}
+	for (int i = 0; i < searches.size(); i++)
+		pool.submit(SearchTile, &searches[i]);
+	pool.wait();
+	pthread_mutex_destroy(&fnLock);
+}
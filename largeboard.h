@@ -0,0 +1,135 @@
+/*
+ * File: largeboard.h
+ * ------------------
+ * Defines the LargeBoard class, a grid of letters of any size, and the
+ * solver for it, for word searches on generated grids far bigger than
+ * the game's boards.
+ */
+
+#ifndef _largeboard_h
+#define _largeboard_h
+
+#include "genlib.h"
+#include "lexicon.h"
+#include "threadpool.h"
+#include "fastrandom.h"
+#include <vector>
+#include <cctype>
+
+
+/*
+ * Class: LargeBoard
+ * -----------------
+ * A large board holds one letter per cell in row-major order, like
+ * Board, but its dimensions are chosen when it is made, so it can be a
+ * thousand cells on a side. Cells are numbered from 0 as in Board, and
+ * two cells are neighbors if they touch horizontally, vertically or
+ * diagonally. Sample use:
+ *
+ *	LargeBoard board(200, 300);
+ *	board.roll(rng);
+ *	char ch = board.letterAt(board.cellAt(row, col));
+ */
+
+class LargeBoard {
+
+  public:
+
+   /*
+    * Constructor: LargeBoard
+    * Usage: LargeBoard board(rows, cols);
+    * ------------------------------------
+    * The constructor makes a board of the given size with a blank in
+    * every cell. Both dimensions must be positive.
+    */
+    LargeBoard(int rows, int cols)
+    {
+        if (rows <= 0 || cols <= 0)
+            Error("LargeBoard needs at least one row and one column");
+        this->rows = rows;
+        this->cols = cols;
+        letters.resize((size_t)rows * cols, ' ');
+    }
+
+    int numRows() const { return rows; }
+    int numCols() const { return cols; }
+    int numCells() const { return rows * cols; }
+    int cellAt(int row, int col) const { return row * cols + col; }
+    int rowOf(int cell) const { return cell / cols; }
+    int colOf(int cell) const { return cell % cols; }
+
+   /*
+    * Member functions: letterAt, setLetterAt
+    * Usage: board.setLetterAt(cell, 'E');
+    * ------------------------------------
+    * These member functions read and write the letter in a cell, which
+    * is stored in upper case. There is no bounds checking.
+    */
+    char letterAt(int cell) const { return letters[cell]; }
+    void setLetterAt(int cell, char ch) { letters[cell] = toupper(ch); }
+
+   /*
+    * Member function: roll
+    * Usage: board.roll(rng);
+    * -----------------------
+    * This member function fills every cell with a random face of a cube
+    * chosen at random from the Big Boggle set, so the letters come up as
+    * often as they do in the game.
+    */
+    void roll(FastRandom & rng);
+
+  private:
+    int rows, cols;
+    std::vector<char> letters;
+};
+
+
+/*
+ * Struct: tileWordsT
+ * ------------------
+ * What the solver reports for one tile of a large board: where the tile
+ * is, and the indexes (see Lexicon::indexOf) of the different words that
+ * can be traced starting in one of its cells, in the order they were
+ * found. A word that starts in more than one tile is in each of them.
+ */
+
+struct tileWordsT {
+	int firstRow, firstCol;
+	int numRows, numCols;
+	std::vector<int> words;
+};
+
+
+/*
+ * Type: tileWordsFnT
+ * ------------------
+ * The type of the function the solver hands each tile's words to, along
+ * with the client data given to SolveLargeBoard.
+ */
+typedef void (*tileWordsFnT)(const tileWordsT & tile, void *data);
+
+
+/*
+ * Function: SolveLargeBoard
+ * Usage: SolveLargeBoard(board, lex, pool, RecordTile, &totals);
+ * --------------------------------------------------------------
+ * This function finds the words of at least MIN_WORD_LENGTH letters
+ * on a large board, by the same rules as SolveBoard. The board is cut
+ * into square tiles of tileSize cells on a side, each searched as one
+ * task on the pool, and each tile's words are passed to fn as soon as
+ * the tile is done, so nothing is kept for the board as a whole.
+ *
+ * A path is never longer than the lexicon's longest word, so every path
+ * starting in a tile stays within that many cells less one of it. Each
+ * task keeps the cubes its path has used in a grid of flags for just
+ * that region, the tile and its halo, so marking and testing a cube
+ * costs the same however big the board is, and at each step only the
+ * eight neighbors are looked at. fn is called from the pool's threads,
+ * but never by two at once, so it needs no locking of its own; tiles
+ * come in no particular order. The lexicon must not change while this
+ * function runs.
+ */
+void SolveLargeBoard(const LargeBoard & board, const Lexicon & lex, ThreadPool & pool, tileWordsFnT fn, void *data,
+					 int tileSize = 64);
+
+#endif
@@ -4,14 +4,15 @@
  * A lexicon is a word list. This lexicon is backed by two separate data structures
  * for storing the words in the list:
  * 1) a dawg (directed acyclic word graph) 
- * 2) a STL set of other words. 
+ * 2) a trie of other words. 
  * Typically the dawg is used for a large list read from a file in binary format.
- * The STL set is for words added piecemeal at runtime.
+ * The trie is for words added piecemeal at runtime, or read from a text file.
+ * Both are searched the same way, one letter at a time down from the root,
+ * so a word or prefix costs about the same to look up in either.
  *
  * The dawg idea comes from an article by Appel & Jacobson, CACM May 1988.
- * This lexicon implementation only has the code to load/search the dawg.
- * The dawg builder code is quite a bit more intricate, see me (Julie)
- * if you need it. 
+ * This file has the code to load, search, and save the dawg; the code that
+ * builds a dawg from a word list is in dawgbuilder.cpp.
  *
  * I originally wrote this for CS016X May 1993, it has had minor tweaks
  * over the years.  This latest C++ incarnation written summer of 2002.
@@ -22,10 +23,11 @@
 
 #include "lexicon.h"
 #include "genlib.h"	// for Error
-#include "strutils.h"	// for ConvertToLowercase
+#include "dawgbuilder.h"
 #include <fstream>	// for ifstream
 #include <cstring>	// for strncmp
-#include <algorithm> 	// find, compare
+#include <algorithm> 	// swap
+#include "mappedfile.h"
 
 /* The dawg is stored as an array of edges. Each edge is represented by 
  * one 32-bit struct.  The 5 "letter" bits indicate the character on this 
@@ -34,15 +36,47 @@
  * "lastEdge" bit marks this as the last edge in a sequence of childeren.  
  * The bulk of the bits (24) are used for the index within the edge array for 
  * the children of this node. The children are laid out contiguously in alphabetical order.
- * Since we read edges as binary bits from a file in a big-endian format, 
- * we have to swap the struct order for little-endian machines.
+ * The file holds each edge as a big-endian 32-bit word, which is taken
+ * apart with shifts and masks (see loadEdges), so reading it doesn't
+ * depend on how the compiler lays out the struct.
+ * Once loaded, the edges are turned into the node array described in
+ * lexicon.h, which is what all the searching uses.
+ *
+ * The native format holds the same edge array, already in the order this
+ * machine uses, after a fixed header that records everything needed to
+ * use it in place: the start node, the edge and word counts, and enough
+ * about the layout to refuse a file written by an incompatible machine.
+ * The node array follows the edges, starting on a cache line boundary,
+ * and the wordsBefore array follows the nodes.
+ * Such a file is mapped read-only into memory instead of being read.
  */
 
+static const char NATIVE_MAGIC[] = "NDWG";
+static const unsigned int NATIVE_VERSION = 3;
+static const unsigned int NATIVE_BYTE_ORDER_MARK = 0x01020304;
+
+struct nativeHeaderT {
+	char magic[4];					// NATIVE_MAGIC, without the terminating null
+	unsigned int version;			// NATIVE_VERSION
+	unsigned int byteOrderMark;		// NATIVE_BYTE_ORDER_MARK as written by the saving machine
+	unsigned int edgeSize;			// sizeof(Edge) on the saving machine
+	unsigned int startIndex;
+	unsigned int numEdges;
+	unsigned int numWords;
+	unsigned int nodesOffset;		// where the nodes start, from the beginning of the file
+};
+
 
 Lexicon::Lexicon() 
 {
 	edges = start = NULL;
 	numEdges = numDawgWords = 0;
+	nodes = NULL;
+	wordsBefore = NULL;
+	nodeStorage = NULL;
+	mapping = NULL;
+	mappingLength = 0;
+	numOtherWords = 0;
 }
 
 
@@ -50,27 +84,98 @@ Lexicon::Lexicon(string filename)
 {
 	edges = start = NULL;
 	numEdges = numDawgWords = 0;
+	nodes = NULL;
+	wordsBefore = NULL;
+	nodeStorage = NULL;
+	mapping = NULL;
+	mappingLength = 0;
+	numOtherWords = 0;
 	addWordsFromFile(filename);
 }
 
 Lexicon::~Lexicon() 
 {
-	if (edges) delete[] edges;
+	releaseEdges();
+}
+
+// Frees the edge and node arrays, or unmaps them if they came from a native file.
+void Lexicon::releaseEdges()
+{
+	if (mapping) UnmapReadOnlyFile(mapping, mappingLength);
+	else if (edges) delete[] edges;
+	if (nodeStorage) delete[] nodeStorage;
+	edges = start = NULL;
+	nodes = NULL;
+	wordsBefore = NULL;
+	nodeStorage = NULL;
+	mapping = NULL;
+	mappingLength = 0;
+	numEdges = numDawgWords = 0;
+}
+
+// Makes room for one node per edge, on a cache line boundary, followed
+// by the wordsBefore entry for each.
+void Lexicon::allocateNodes()
+{
+	nodeStorage = new char[numEdges * (sizeof(Node) + sizeof(unsigned int)) + NODE_ALIGNMENT];
+	size_t offset = (NODE_ALIGNMENT - (size_t)nodeStorage % NODE_ALIGNMENT) % NODE_ALIGNMENT;
+	nodes = (Node *)(nodeStorage + offset);
+	wordsBefore = (unsigned int *)(nodes + numEdges);
+}
+
+// Builds the node for each edge from the run of edges it leads to, then
+// counts the words. The bit counts only find the right child if each run
+// is in alphabetical order, so edges that aren't are rejected along with
+// any other damage.
+void Lexicon::buildNodes()
+{
+	allocateNodes();
+	for (int i = 0; i < numEdges; i++) {
+		int run = (i == 0) ? start - edges : edges[i].children;
+		nodes[i].mask = (i != 0 && edges[i].accept) ? (unsigned int)NODE_ACCEPT : 0u;
+		nodes[i].children = run;
+		if (run == 0) continue;		// no children
+		unsigned int previous = 0;
+		for (int j = run; ; j++) {
+			if (j >= numEdges || edges[j].letter <= previous || edges[j].letter > 26)
+				Error("Improperly formed lexicon data");
+			previous = edges[j].letter;
+			nodes[i].mask |= 1u << (previous - 1);
+			if (edges[j].lastEdge) break;
+		}
+	}
+	numDawgWords = countWordsBefore();
 }
 
-#if defined(BYTE_ORDER) && BYTE_ORDER == LITTLE_ENDIAN
-// swaps a 4-byte long from big to little endian byte order
-static unsigned long my_ntohl(unsigned long arg)
+// Returns the number of words at or below a node, remembering the count
+// for each node so that shared ones are only counted once.
+int Lexicon::recCountWords(int node, std::vector<int> & counts) const
 {
-	unsigned long result =  ((arg & 0xff000000) >> 24) |
-                            ((arg & 0x00ff0000) >> 8) |
-                            ((arg & 0x0000ff00) << 8) |
-                            ((arg & 0x000000ff) << 24);
-	return result;
+	if (counts[node] != -1) return counts[node];
+	int count = (nodes[node].mask & NODE_ACCEPT) ? 1 : 0;
+	int numChildren = countBits(nodes[node].mask & NODE_LETTERS);
+	for (int i = 0; i < numChildren; i++)
+		count += recCountWords(nodes[node].children + i, counts);
+	return counts[node] = count;
 }
-#endif
 
-static void CountWord(string word, int &count) { count++; }
+// Fills in wordsBefore for every node, and returns the number of words
+// in the dawg.
+int Lexicon::countWordsBefore()
+{
+	std::vector<int> counts(numEdges, -1);
+	int numWords = recCountWords(0, counts);
+	for (int i = 0; i < numEdges; i++)
+		wordsBefore[i] = 0;
+	for (int i = 0; i < numEdges; i++) {
+		if (counts[i] == -1) continue;		// not reachable from the start
+		int first = nodes[i].children;
+		int numChildren = countBits(nodes[i].mask & NODE_LETTERS);
+		for (int k = 1; k < numChildren; k++)
+			wordsBefore[first + k] = wordsBefore[first + k - 1] + counts[first + k - 1];
+	}
+	return numWords;
+}
 
 // Binary lexicon file format must follow this pattern
 // DAWG:<startnode index>:<num bytes>:<num bytes block of edge data>:
@@ -89,28 +194,272 @@ void Lexicon::readBinaryFile(string filename)
     istr.get(); // skip second colon
     istr >> numBytes;
     istr.get(); // skip third colon
-	if (istr.fail() || strncmp(firstFour, expected, 4) != 0 || startIndex < 0 || numBytes < 0)
+	if (istr.fail() || strncmp(firstFour, expected, 4) != 0 || startIndex < 0 || numBytes < (long)sizeof(Edge)
+		|| startIndex >= numBytes/(long)sizeof(Edge))
 		Error("Improperly formed lexicon file " + filename);
 
-	numEdges = numBytes/sizeof(Edge);
-	edges = new Edge[numEdges];
-	start = &edges[startIndex];
-    istr.read((char *)edges, numBytes);
+	std::vector<unsigned char> bytes(numBytes / 4 * 4, 0);
+    istr.read((char *)&bytes[0], bytes.size());
     if (istr.fail() && !istr.eof())
 		Error("Improperly formed lexicon file " + filename);
+	istr.close();
+
+	std::vector<unsigned int> packed(bytes.size() / 4);
+	for (int i = 0; i < packed.size(); i++) {		// each edge is a big-endian 32-bit word
+		const unsigned char *b = &bytes[4 * i];
+		packed[i] = ((unsigned int)b[0] << 24) | ((unsigned int)b[1] << 16) | ((unsigned int)b[2] << 8) | b[3];
+	}
+	loadEdges(packed, startIndex);
+}
 
-#if defined(BYTE_ORDER) && BYTE_ORDER == LITTLE_ENDIAN
-	unsigned long *cur = (unsigned long *)edges;
-	for (int i = 0; i < numEdges; i++, cur++)
-		*cur = my_ntohl(*cur);	// swap to get children index in LSB order
-#endif
+// Checks the header of a native file and maps the edges that follow it.
+// The mapping is read-only and shared, so every process using the file
+// uses the same pages of memory.
+void Lexicon::readNativeFile(string filename)
+{
+	nativeHeaderT header;
+	ifstream istr(filename.c_str(), ios::in|ios::binary);
+	if (istr.fail())
+		Error("Couldn't open lexicon file " + filename);
+	istr.read((char *)&header, sizeof(header));
+	istr.seekg(0, ios::end);
+	long fileLength = istr.tellg();
 	istr.close();
-	numDawgWords = 0;
-	recMapAll(start, true, "", CountWord, numDawgWords);
+	if (fileLength < (long)sizeof(header) || strncmp(header.magic, NATIVE_MAGIC, 4) != 0)
+		Error("Improperly formed lexicon file " + filename);
+	if (header.version != NATIVE_VERSION || header.byteOrderMark != NATIVE_BYTE_ORDER_MARK
+		|| header.edgeSize != sizeof(Edge))
+		Error("Lexicon file " + filename + " was saved by an incompatible program or machine");
+	if (header.numEdges == 0 || header.startIndex >= header.numEdges
+		|| header.nodesOffset % NODE_ALIGNMENT != 0
+		|| header.nodesOffset < sizeof(header) + (long)header.numEdges * sizeof(Edge)
+		|| fileLength != (long)header.nodesOffset + (long)header.numEdges * (long)(sizeof(Node) + sizeof(unsigned int)))
+		Error("Improperly formed lexicon file " + filename);
+
+	releaseEdges();
+	const char *base = (const char *)MapReadOnlyFile(filename, fileLength);
+	if (base == NULL)
+		Error("Couldn't map lexicon file " + filename);
+	mapping = base;
+	mappingLength = fileLength;
+	edges = (Edge *)(base + sizeof(header));		// never written through, since the mapping is read-only
+	nodes = (Node *)(base + header.nodesOffset);	// the mapping starts on a page boundary, so this is aligned
+	wordsBefore = (unsigned int *)(nodes + header.numEdges);
+	numEdges = header.numEdges;
+	start = &edges[header.startIndex];
+	numDawgWords = header.numWords;
+}
+
+// Replaces the dawg with one built by DawgBuilder. The fields are set one
+// at a time, so this works whatever order the compiler lays them out in.
+void Lexicon::loadEdges(const std::vector<unsigned int> & packed, int startIndex)
+{
+	releaseEdges();
+	numEdges = packed.size();
+	edges = new Edge[numEdges];
+	for (int i = 0; i < numEdges; i++) {
+		edges[i].children = packed[i] >> 8;
+		edges[i].unused = 0;
+		edges[i].accept = (packed[i] >> 6) & 1;
+		edges[i].lastEdge = (packed[i] >> 5) & 1;
+		edges[i].letter = packed[i] & 0x1f;
+	}
+	start = &edges[startIndex];
+	buildNodes();
+}
+
+static void AddToBuilder(string word, DawgBuilder &builder)
+{
+	builder.add(word);
+}
+
+// Adds each prefix of a word to the builder, spelled backward.
+static void AddReversedPrefixes(string word, DawgBuilder &builder)
+{
+	string reversed;
+	for (int i = 0; i < word.length(); i++) {
+		reversed.insert(reversed.begin(), word[i]);
+		builder.add(reversed);
+	}
+}
+
+void Lexicon::extractReversedPrefixes(Lexicon & result) const
+{
+	DawgBuilder builder;
+	mapAll(AddReversedPrefixes, builder);
+	std::vector<unsigned int> packed;
+	int startIndex = builder.build(packed);
+	result.clear();
+	result.loadEdges(packed, startIndex);
+}
+
+// Collects the words the dawg has no letters for, which compact leaves in the trie.
+static void CollectUnbuildable(string word, std::vector<string> &words)
+{
+	if (!DawgBuilder::canHold(word)) words.push_back(word);
+}
+
+void Lexicon::compact()
+{
+	if (numOtherWords == 0 && edges != NULL) return;
+	DawgBuilder builder;
+	std::vector<string> leftOver;
+	mapAll(AddToBuilder, builder);
+	if (!otherWords.empty()) {
+		mapAllVisitorT<std::vector<string> > collect;
+		collect.fn = CollectUnbuildable;
+		collect.data = &leftOver;
+		string soFar;
+		recVisitTrie(0, soFar, collect);
+	}
+	std::vector<unsigned int> packed;
+	int startIndex = builder.build(packed);
+	loadEdges(packed, startIndex);
+	otherWords.clear();
+	otherWordNodes.clear();
+	numOtherWords = 0;
+	for (int i = 0; i < leftOver.size(); i++)
+		add(leftOver[i]);
+}
+
+void Lexicon::writeBinaryFile(string filename)
+{
+	writeDawgFile(filename, false);
+}
+
+void Lexicon::writeNativeFile(string filename)
+{
+	writeDawgFile(filename, true);
+}
+
+// Writes the portable format (big-endian, in the field order of the
+// on-disk edge) or the native one (a straight copy of memory). Both hold
+// nothing but the dawg, so a lexicon with added words, or with no words at
+// all, is compacted into a copy and the copy is written.
+void Lexicon::writeDawgFile(string filename, bool native) const
+{
+	if (numOtherWords != 0 || edges == NULL) {
+		Lexicon compacted(*this);
+		compacted.compact();
+		if (compacted.numOtherWords != 0)
+			Error("Words with characters other than a to z can't be saved in lexicon file " + filename);
+		compacted.writeDawgFile(filename, native);
+		return;
+	}
+	ofstream ostr(filename.c_str(), ios::out|ios::binary);
+	if (native) {
+		nativeHeaderT header;
+		memset(&header, 0, sizeof(header));
+		memcpy(header.magic, NATIVE_MAGIC, 4);
+		header.version = NATIVE_VERSION;
+		header.byteOrderMark = NATIVE_BYTE_ORDER_MARK;
+		header.edgeSize = sizeof(Edge);
+		header.startIndex = start - edges;
+		header.numEdges = numEdges;
+		header.numWords = numDawgWords;
+		long edgesEnd = sizeof(header) + (long)numEdges * sizeof(Edge);
+		header.nodesOffset = (edgesEnd + NODE_ALIGNMENT - 1) / NODE_ALIGNMENT * NODE_ALIGNMENT;
+		ostr.write((char *)&header, sizeof(header));
+		ostr.write((char *)edges, (long)numEdges * sizeof(Edge));
+		char padding[NODE_ALIGNMENT] = { 0 };
+		ostr.write(padding, header.nodesOffset - edgesEnd);
+		ostr.write((char *)nodes, (long)numEdges * sizeof(Node));
+		ostr.write((char *)wordsBefore, (long)numEdges * sizeof(unsigned int));
+	} else {
+		ostr << "DAWG:" << (start - edges) << ":" << (long)numEdges * 4 << ":";
+		for (int i = 0; i < numEdges; i++) {
+			unsigned int packed = (edges[i].children << 8) | (edges[i].accept << 6)
+								| (edges[i].lastEdge << 5) | edges[i].letter;
+			char bytes[4] = { (char)(packed >> 24), (char)(packed >> 16), (char)(packed >> 8), (char)packed };
+			ostr.write(bytes, 4);
+		}
+	}
+	ostr.close();
+	if (ostr.fail())
+		Error("Couldn't write lexicon file " + filename);
+}
+
+// Finds the letters that follow a position, which may be in the dawg, in
+// the trie, or both, and keeps each one that is allowed here, that the
+// counts allow, and that leads to at least one word. The kept letters' edges are appended to the
+// output as one run, after the runs of their own children. Returns the
+// new node's mask, or 0 if nothing can be spelled from here.
+unsigned int Lexicon::recExtract(int node, int trieNode, unsigned int allowed, int counts[], const unsigned int follows[],
+								 std::vector<Edge> & outEdges, std::vector<Node> & outNodes) const
+{
+	unsigned int candidates = (node != -1) ? nodes[node].mask & NODE_LETTERS : 0;
+	if (trieNode != -1) {
+		for (int child = otherWords[trieNode].firstChild; child != 0; child = otherWords[child].nextSibling) {
+			unsigned int ord = charToOrd(otherWords[child].letter) - 1;
+			if (ord < 26) candidates |= 1u << ord;
+		}
+	}
+	candidates &= allowed;
+	Node kept[26];
+	int keptOrds[26], numKept = 0;
+	unsigned int mask = 0;
+	for (int ord = 0; ord < 26; ord++) {
+		if (!(candidates & (1u << ord)) || counts[ord] == 0) continue;
+		char ch = 'a' + ord;
+		counts[ord]--;
+		Node child;
+		child.mask = recExtract(node != -1 ? findChildNode(node, ch) : -1,
+								trieNode != -1 ? findTrieChild(trieNode, ch) : -1,
+								follows ? follows[ord] : NODE_LETTERS, counts, follows,
+								outEdges, outNodes);
+		child.children = outEdges.size() - countBits(child.mask & NODE_LETTERS);
+		counts[ord]++;
+		if (child.mask != 0) {
+			mask |= 1u << ord;
+			keptOrds[numKept] = ord;
+			kept[numKept++] = child;
+		}
+	}
+	for (int i = 0; i < numKept; i++) {
+		Edge edge;
+		edge.letter = keptOrds[i] + 1;
+		edge.lastEdge = (i == numKept - 1);
+		edge.accept = (kept[i].mask & NODE_ACCEPT) != 0;
+		edge.unused = 0;
+		if (!(kept[i].mask & NODE_LETTERS)) kept[i].children = 0;
+		edge.children = kept[i].children;
+		outEdges.push_back(edge);
+		outNodes.push_back(kept[i]);
+	}
+	bool accept = (node != -1 && (nodes[node].mask & NODE_ACCEPT))
+				  || (trieNode != -1 && otherWords[trieNode].accept);
+	return mask | (accept ? (unsigned int)NODE_ACCEPT : 0u);
+}
+
+void Lexicon::extractSpelledFrom(string letters, Lexicon & result, const unsigned int follows[]) const
+{
+	int counts[26];
+	for (int ord = 0; ord < 26; ord++)
+		counts[ord] = 0;
+	for (int i = 0; i < letters.length(); i++) {
+		unsigned int ord = charToOrd(letters[i]) - 1;
+		if (ord < 26) counts[ord]++;
+	}
+	std::vector<Edge> outEdges(1);		// edge 0 is a placeholder, and node 0 the start
+	std::vector<Node> outNodes(1);
+	unsigned int rootMask = recExtract(nodes ? 0 : -1, otherWords.empty() ? -1 : 0, NODE_LETTERS, counts, follows,
+									   outEdges, outNodes);
+	outNodes[0].mask = rootMask & NODE_LETTERS;		// the empty string isn't kept
+	outNodes[0].children = outEdges.size() - countBits(outNodes[0].mask);
+
+	result.clear();
+	result.numEdges = outEdges.size();
+	result.edges = new Edge[result.numEdges];
+	memcpy(result.edges, &outEdges[0], sizeof(Edge) * result.numEdges);
+	result.start = &result.edges[outNodes[0].mask ? outNodes[0].children : 0];
+	result.allocateNodes();
+	memcpy(result.nodes, &outNodes[0], sizeof(Node) * result.numEdges);
+	if (!outNodes[0].mask) result.nodes[0].children = 0;
+	result.numDawgWords = result.countWordsBefore();
 }
 
 // Check for DAWG in first 4 to identify as special binary format,
-// otherwise assume ascii, one word per line
+// or NDWG for the native format, otherwise assume ascii, one word per line
 void Lexicon::addWordsFromFile(string filename) 
 {
 	char firstFour[4], expected[] = "DAWG";
@@ -124,6 +473,10 @@ void Lexicon::addWordsFromFile(string filename)
 		readBinaryFile(filename);
 		return;
 	}
+	if (strncmp(firstFour, NATIVE_MAGIC, 4) == 0) {
+		readNativeFile(filename);
+		return;
+	}
 
 	istr.seekg(0);	// return back to beginning
 	string line;
@@ -132,12 +485,12 @@ void Lexicon::addWordsFromFile(string filename)
 	istr.close();
 }
 
-int Lexicon::size() 
+int Lexicon::size() const
 {
-	return numDawgWords + otherWords.size();
+	return numDawgWords + numOtherWords;
 }
 
-bool Lexicon::isEmpty() 
+bool Lexicon::isEmpty() const
 {
 	return size() == 0;
 }
@@ -145,80 +498,230 @@ bool Lexicon::isEmpty()
 
 void Lexicon::clear() 
 {
-	if (edges) delete[] edges;
-	edges = start = NULL;
-	numEdges = numDawgWords = 0;
+	releaseEdges();
 	otherWords.clear();
+	otherWordNodes.clear();
+	numOtherWords = 0;
 }
 
-// Iterate over sequence of children to find one that
-// matches the given char.  returns NULL if we get to
-// last child without finding a match (thus no such
-// child edge exists).
-Lexicon::Edge *Lexicon::findEdgeForChar(Edge *children, char ch) 
+// given a string, trace out path through the dawg
+// node-by-node. Returns the node reached, or -1 if there is no such path
+int Lexicon::traceNodes(const string& s) const
 {
-	Edge *curEdge = children;
-	while (true) {
-		if (curEdge->letter == charToOrd(ch))
-			return curEdge;
-		if (curEdge->lastEdge)
-			return NULL;
-		curEdge++;	// advance to next sibilng
-	}
-}
-
-// given a string, trace out path through
-// dawg edge-by-edge. If path exists, return last edge
-// else returns NULL
-Lexicon::Edge *Lexicon::traceToLastEdge(const string& s) 
-{
-	if (!start) return NULL;
-	Edge *curEdge = findEdgeForChar(start, s[0]);
-	for (int i = 1;  i < s.length(); i++) {
-            if (!curEdge || !curEdge->children) return NULL;
-            curEdge = findEdgeForChar(&edges[curEdge->children], s[i]);
-	}
-	return curEdge;
-}
-
-// Predicate function object used to prefix-match on the
-// other words collection.
-class MatchPrefix {
-  private:
-	string p;
-  public:
-    MatchPrefix(const string &prefix) : p(ConvertToLowerCase(prefix)) {}
-    bool operator()(const string& str) const { 
-#if defined(__GNUC__) && __GNUC__ < 3 // 2.95 has the old parameter order... sigh
-        return str.compare(p, 0, p.length()) == 0; 
-#else
-        return str.compare(0, p.length(), p) == 0;
-#endif
-    }
-};
+	if (!nodes) return -1;
+	int node = 0;
+	for (int i = 0; i < s.length() && node != -1; i++)
+		node = findChildNode(node, s[i]);
+	return node;
+}
+
+// Find the child of a trie node for the given char, or -1 if
+// there is none.  Siblings are in order, so we can stop looking
+// as soon as we pass where it would be.
+int Lexicon::findTrieChild(int node, char ch) const
+{
+	ch = tolower(ch);
+	for (int child = otherWords[node].firstChild; child != 0; child = otherWords[child].nextSibling) {
+		if (otherWords[child].letter == ch)
+			return child;
+		if (otherWords[child].letter > ch)
+			break;
+	}
+	return -1;
+}
+
+// given a string, trace out path through the trie of other
+// words. Returns the node reached, or -1 if there is no such path
+int Lexicon::traceTrie(const string& s) const
+{
+	if (otherWords.empty()) return -1;
+	int node = 0;
+	for (int i = 0; i < s.length() && node != -1; i++)
+		node = findTrieChild(node, s[i]);
+	return node;
+}
 
 
-bool Lexicon::containsPrefix(string prefix)
+bool Lexicon::containsPrefix(string prefix) const
 {
 	if (prefix.empty()) return true;
-	if (traceToLastEdge(prefix)) return true;
-	return find_if(otherWords.begin(), otherWords.end(), MatchPrefix(prefix)) != otherWords.end();	
+	if (traceNodes(prefix) != -1) return true;
+	return traceTrie(prefix) != -1;
 }
 
 
-bool Lexicon::containsWord(string word) 
+bool Lexicon::containsWord(string word) const
 {
-	Edge *lastEdge = traceToLastEdge(word);
-	if (lastEdge && lastEdge->accept) return true;
-	// check list of other words if not found in dawg
-	return otherWords.find(ConvertToLowerCase(word)) != otherWords.end();
+	int node = traceNodes(word);
+	if (node != -1 && (nodes[node].mask & NODE_ACCEPT)) return true;
+	// check trie of other words if not found in dawg
+	node = traceTrie(word);
+	return node != -1 && otherWords[node].accept;
 }
 
 
+// Walks the word down the trie, adding nodes for any letters not already
+// there, each in its place among its siblings. We store words in all lowercase.
 void Lexicon::add(string word)
 {
-	if (!containsWord(word)) // don't add duplicate (set uniques, but need check dawg too)
-		otherWords.insert(ConvertToLowerCase(word)); // we store words in all lowercase
+	if (containsWord(word)) return; // don't add duplicate (trie uniques, but need check dawg too)
+	if (otherWords.empty()) {
+		TrieNode root = { 0, 0, '\0', false, 0, -1 };
+		otherWords.push_back(root);
+	}
+	int node = 0;
+	for (int i = 0; i < word.length(); i++) {
+		char ch = tolower(word[i]);
+		int *link = &otherWords[node].firstChild;
+		while (*link != 0 && otherWords[*link].letter < ch)
+			link = &otherWords[*link].nextSibling;
+		if (*link == 0 || otherWords[*link].letter != ch) {
+			TrieNode child = { 0, *link, ch, false, node, -1 };
+			*link = otherWords.size();
+			otherWords.push_back(child);	// may move the nodes, so link isn't used after this
+			node = otherWords.size() - 1;
+		} else {
+			node = *link;
+		}
+	}
+	otherWords[node].accept = true;
+	otherWords[node].wordIndex = numOtherWords++;
+	otherWordNodes.push_back(node);
+}
+
+int Lexicon::indexOf(string word) const
+{
+	Cursor cur = cursor();
+	for (int i = 0; i < word.length(); i++) {
+		if (!cur.advance(word[i])) return -1;
+	}
+	return cur.wordIndex();
+}
+
+// A dawg word is found by counting down from the start: at each node,
+// the word ending there (if any) comes first, and the rest are split
+// among the children by their wordsBefore entries.
+string Lexicon::wordAt(int index) const
+{
+	if (index < 0 || index >= size())
+		Error("Lexicon::wordAt called with an index that isn't a word");
+	string word;
+	if (index >= numDawgWords) {
+		for (int node = otherWordNodes[index - numDawgWords]; node != 0; node = otherWords[node].parent)
+			word = otherWords[node].letter + word;
+		return word;
+	}
+	int node = 0, remaining = index;
+	while (true) {
+		if (nodes[node].mask & NODE_ACCEPT) {
+			if (remaining == 0) return word;
+			remaining--;
+		}
+		unsigned int letters = nodes[node].mask & NODE_LETTERS;
+		int first = nodes[node].children;
+		int child = countBits(letters) - 1;
+		while (child > 0 && wordsBefore[first + child] > remaining)
+			child--;
+		remaining -= wordsBefore[first + child];
+		for (int i = 0; i < child; i++)
+			letters &= letters - 1;			// drops the lowest letter
+		word += ordToChar(countBits((letters & (0 - letters)) - 1) + 1);
+		node = first + child;
+	}
+}
+
+string Lexicon::lowerCase(string s)
+{
+	for (int i = 0; i < s.length(); i++)
+		s[i] = tolower(s[i]);
+	return s;
+}
+
+Lexicon::Iterator Lexicon::iterator(string prefix) const
+{
+	Iterator itr;
+	itr.lex = this;
+	itr.word = lowerCase(prefix);
+	itr.prefixLength = itr.word.length();
+	itr.inTrie = false;
+	itr.trieStart = traceTrie(itr.word);
+	itr.entered = itr.haveWord = false;
+	int node = traceNodes(itr.word);
+	if (node != -1) {
+		Iterator::frameT frame = { node, nodes[node].mask & NODE_LETTERS, (int)nodes[node].children };
+		itr.path.push_back(frame);
+		itr.entered = true;
+	} else {
+		itr.enterTrie();
+	}
+	return itr;
+}
+
+// Starts on the words in the trie, once those in the dawg are done.
+void Lexicon::Iterator::enterTrie()
+{
+	inTrie = true;
+	path.clear();
+	word.erase(prefixLength);
+	if (trieStart != -1) {
+		frameT frame = { trieStart, 0, lex->otherWords[trieStart].firstChild };
+		path.push_back(frame);
+		entered = true;
+	}
+}
+
+// Walks on until word holds the next word, returning false if there is
+// none. It is the same walk as visitWords, with the recursion kept in path.
+bool Lexicon::Iterator::findWord()
+{
+	while (true) {
+		if (path.empty()) {
+			if (inTrie) return false;
+			enterTrie();
+			continue;
+		}
+		frameT & top = path.back();
+		if (entered) {
+			entered = false;
+			if (inTrie ? lex->otherWords[top.node].accept : (lex->nodes[top.node].mask & NODE_ACCEPT) != 0)
+				return true;
+		}
+		frameT next;
+		if (!inTrie && top.letters != 0) {
+			unsigned int lowest = top.letters & (0 - top.letters);
+			top.letters &= top.letters - 1;
+			next.node = top.child++;
+			next.letters = lex->nodes[next.node].mask & NODE_LETTERS;
+			next.child = lex->nodes[next.node].children;
+			word += char('a' + countBits(lowest - 1));
+		} else if (inTrie && top.child != 0) {
+			next.node = top.child;
+			next.letters = 0;
+			next.child = lex->otherWords[next.node].firstChild;
+			top.child = lex->otherWords[next.node].nextSibling;
+			word += lex->otherWords[next.node].letter;
+		} else {
+			path.pop_back();				// done with this node
+			if (!path.empty()) word.erase(word.length() - 1);
+			continue;
+		}
+		path.push_back(next);				// top isn't used after this, as it may move
+		entered = true;
+	}
+}
+
+bool Lexicon::Iterator::hasNext()
+{
+	if (!haveWord) haveWord = findWord();
+	return haveWord;
+}
+
+const string & Lexicon::Iterator::next()
+{
+	if (!hasNext())
+		Error("Lexicon::Iterator::next called with no words left");
+	haveWord = false;
+	return word;
 }
 
 Lexicon::Lexicon(const Lexicon &rhs)
@@ -229,24 +732,51 @@ Lexicon::Lexicon(const Lexicon &rhs)
 const Lexicon & Lexicon::operator=(const Lexicon &rhs)
 {
 	if (this != &rhs) {
-		delete[] edges;
+		releaseEdges();
 		copyContentsFrom(rhs);			
 	}
 	return *this;
 }
 
+void Lexicon::swap(Lexicon &other)
+{
+	std::swap(edges, other.edges);
+	std::swap(start, other.start);
+	std::swap(numEdges, other.numEdges);
+	std::swap(numDawgWords, other.numDawgWords);
+	std::swap(nodes, other.nodes);
+	std::swap(wordsBefore, other.wordsBefore);
+	std::swap(nodeStorage, other.nodeStorage);
+	std::swap(mapping, other.mapping);
+	std::swap(mappingLength, other.mappingLength);
+	otherWords.swap(other.otherWords);
+	otherWordNodes.swap(other.otherWordNodes);
+	std::swap(numOtherWords, other.numOtherWords);
+}
+
+// Copies are always held in memory of their own, even if rhs is mapped.
 void Lexicon::copyContentsFrom(const Lexicon &rhs)
 {
+    mapping = NULL;
+    mappingLength = 0;
     if (rhs.edges != NULL && rhs.numEdges != 0) {
         numEdges = rhs.numEdges;
         edges = new Edge[rhs.numEdges];
         memcpy(edges, rhs.edges, sizeof(Edge)*rhs.numEdges);
         start = edges + (rhs.start - rhs.edges);
         numDawgWords = rhs.numDawgWords;
+        allocateNodes();
+        memcpy(nodes, rhs.nodes, sizeof(Node)*rhs.numEdges);
+        memcpy(wordsBefore, rhs.wordsBefore, sizeof(unsigned int)*rhs.numEdges);
     } else {
         edges = start = NULL;
         numEdges = numDawgWords = 0;
+        nodes = NULL;
+        wordsBefore = NULL;
+        nodeStorage = NULL;
      }
     otherWords = rhs.otherWords;
+    otherWordNodes = rhs.otherWordNodes;
+    numOtherWords = rhs.numOtherWords;
 }
 
@@ -10,7 +10,10 @@
 
 #include <string>
 #include "genlib.h"
-#include <set>
+#include <vector>
+#ifndef _MSC_VER
+#include <sys/types.h>	// for BYTE_ORDER, which Edge's layout depends on
+#endif
 
 /*
  * Class: Lexicon
@@ -75,7 +78,7 @@ class Lexicon {
     * --------------------------
     * This member function returns the number of words contained in this lexicon.
     */
-    int size();
+    int size() const;
     
    /*
     * Member function: isEmpty
@@ -83,7 +86,7 @@ class Lexicon {
     * --------------------------
     * This member function returns true if this lexicon contains no words, false otherwise.
     */
-    bool isEmpty();
+    bool isEmpty() const;
 
     
    /*
@@ -106,6 +109,85 @@ class Lexicon {
     */
 	void addWordsFromFile(string filename);
 
+   /*
+    * Member function: writeNativeFile
+    * Usage: lex.writeNativeFile("lexicon.ndwg");
+    * -------------------------------------------
+    * This member function saves the lexicon in a second binary format that
+    * is laid out exactly as the lexicon is held in memory on this machine.
+    * Loading a native file (with the constructor or addWordsFromFile) maps
+    * it into memory rather than reading it, so it takes the same short time
+    * whatever the size of the word list, and programs on the same machine
+    * that load the same file share one copy of it. Native files can only be
+    * loaded on machines with the same byte order as the one that wrote them;
+    * use the portable format for files that move between machines. Added
+    * words are saved along with the rest, as for writeBinaryFile.
+    */
+	void writeNativeFile(string filename);
+
+   /*
+    * Member function: writeBinaryFile
+    * Usage: lex.writeBinaryFile("lexicon.dat");
+    * ------------------------------------------
+    * This member function saves the lexicon in the portable binary format
+    * accepted by the constructor and addWordsFromFile, which reads the same
+    * on any machine. All of the words are saved, including those added one
+    * at a time or read from a text file; they are compiled into the saved
+    * dawg without changing this lexicon. The format only holds the letters
+    * a to z, so if some word contains any other character, Error is called.
+    */
+	void writeBinaryFile(string filename);
+
+   /*
+    * Member function: compact
+    * Usage: lex.compact();
+    * ---------------------
+    * This member function rebuilds the lexicon so that the words added at
+    * runtime or read from a text file are held in the same compact dawg as
+    * the words read from a binary file. It doesn't change which words the
+    * lexicon contains, but afterwards those words take much less memory
+    * and are a little faster to look up. Words containing characters other
+    * than the letters a to z can't go in the dawg and stay where they are.
+    * Any cursor made before compacting must not be used afterwards.
+    */
+	void compact();
+
+
+   /*
+    * Member function: extractSpelledFrom
+    * Usage: lex.extractSpelledFrom("TRSAEBOLNGIEDMUC", boardLex);
+    *        lex.extractSpelledFrom(letters, boardLex, follows);
+    * -------------------------------------------------------------
+    * This member function replaces the contents of result with the words
+    * of this lexicon that can be spelled from the given letters, using each
+    * letter no more often than it appears there (case-insensitively, and
+    * ignoring anything that isn't a letter). If follows is given, it has an
+    * entry for each letter from 'a' to 'z', with bit i set if the letter
+    * 'a' + i may come next; words with any other pair of letters in a row
+    * are left out as well. Filled in from the cubes of a Boggle board, the
+    * result holds every word that could be on the board, usually a tiny
+    * fraction of the whole lexicon, and searching the board against it
+    * touches far less memory. Words containing characters other than the
+    * letters a to z are never included.
+    */
+    void extractSpelledFrom(string letters, Lexicon & result, const unsigned int follows[] = NULL) const;
+
+   /*
+    * Member function: extractReversedPrefixes
+    * Usage: lex.extractReversedPrefixes(reversed);
+    * ---------------------------------------------
+    * This member function replaces the contents of result with every
+    * prefix of every word in this lexicon, spelled backward: "cat" puts
+    * "c", "ac" and "tac" in result. The prefixes of the result are then
+    * exactly the pieces of words spelled backward, so a search can start
+    * in the middle of a word and work back toward its beginning, knowing
+    * at each step whether some word has the letters seen so far in that
+    * place and, once result contains them, that they begin a word. As
+    * with compact, words with characters other than the letters a to z
+    * are left out.
+    */
+    void extractReversedPrefixes(Lexicon & result) const;
+
 
    /*
     * Member function: containsWord
@@ -115,7 +197,7 @@ class Lexicon {
     * false otherwise.  Words are considered case-insensitively, "zoo" is the
     * same as "ZOO" or "zoo".
     */
-    bool containsWord(string word);    
+    bool containsWord(string word) const;
     
     
    /*
@@ -127,7 +209,51 @@ class Lexicon {
     * and the empty string is a prefix of everything. Prefixes are considered 
     * case-insensitively, "mo" is a prefix of "MONKEY" or "Monday".
     */
-    bool containsPrefix(string prefix);
+    bool containsPrefix(string prefix) const;
+
+
+   /*
+    * Member functions: indexOf, wordAt
+    * Usage: int index = lex.indexOf("happy");
+    *        string word = lex.wordAt(index);
+    * ----------------------------------------
+    * Each word in the lexicon has an index from 0 to size()-1, with no
+    * gaps, so a program can keep track of words with integers and sets of
+    * bits rather than strings. indexOf returns the index of a word, or -1
+    * if it isn't in the lexicon; wordAt returns the word (in lower case)
+    * with a given index, or calls Error if there's none. The words read
+    * from a binary file come first, in alphabetical order, followed by the
+    * other words in the order they were added. Indexes only stay the same
+    * while the lexicon is unchanged.
+    */
+    int indexOf(string word) const;
+    string wordAt(int index) const;
+
+
+   /*
+    * Class: Cursor
+    * -------------
+    * A cursor marks a position partway through tracing a word. Where
+    * containsWord and containsPrefix trace the whole string from the
+    * beginning on every call, a cursor remembers how far it has gotten,
+    * so extending the prefix by one letter costs a single child lookup.
+    * Cursors are small and are intended to be copied by value, which makes
+    * them convenient to carry down a recursive search. A cursor is only
+    * valid while the lexicon it came from is unchanged. Sample use:
+    *
+    *	Lexicon::Cursor cur = lex.cursor();
+    *	if (cur.advance('c') && cur.advance('a') && cur.advance('t') && cur.isWord())
+    *		...
+    */
+    class Cursor;
+
+   /*
+    * Member function: cursor
+    * Usage: Lexicon::Cursor cur = lex.cursor();
+    * ------------------------------------------
+    * This member function returns a cursor positioned at the empty prefix.
+    */
+    Cursor cursor() const;
 
 
    /*
@@ -159,7 +285,53 @@ class Lexicon {
 	 * type is needed for the client's callback.
 	 */
 	template <typename ClientDataType>
-	  void mapAll(void (fn)(string word, ClientDataType &), ClientDataType &data);
+	  void mapAll(void (fn)(string word, ClientDataType &), ClientDataType &data) const;
+
+	/*
+	 * Member function: visitWords
+	 * Usage: counter = lexicon.visitWords(counter);
+	 *        counter = lexicon.visitWords("qu", counter);
+	 * -----------------------------------------------
+	 * This member function calls visitor(word) once for each word, in the
+	 * same order as mapAll, or just for the words beginning with prefix
+	 * (case-insensitively), and returns the visitor when it is done, as
+	 * std::for_each does, so a functor can gather results in its own
+	 * fields. The visitor can be a function taking a const string & or any
+	 * object with an operator() that does, and since the visitor's type is
+	 * a template parameter the call can be inlined. Every word is spelled
+	 * in the same string, which grows and shrinks by a letter at each step
+	 * of the walk, so nothing is copied along the way; a visitor that needs
+	 * to keep a word must copy it.
+	 */
+	template <typename VisitorType>
+	  VisitorType visitWords(VisitorType visitor) const;
+	template <typename VisitorType>
+	  VisitorType visitWords(string prefix, VisitorType visitor) const;
+
+	/*
+	 * Class: Iterator
+	 * ---------------
+	 * An iterator steps through the words of a lexicon, or those beginning
+	 * with a prefix, in the same order as mapAll, for code that wants to
+	 * stop partway or to interleave the words with something else. Like
+	 * visitWords it spells each word in one string of its own, so next
+	 * returns a reference that is good until hasNext or next is called
+	 * again. Sample use:
+	 *
+	 *	Lexicon::Iterator itr = lex.iterator("qu");
+	 *	while (itr.hasNext())
+	 *		cout << itr.next() << endl;
+	 */
+	class Iterator;
+
+	/*
+	 * Member function: iterator
+	 * Usage: Lexicon::Iterator itr = lex.iterator();
+	 * ----------------------------------------------
+	 * This member function returns an iterator over the words beginning
+	 * with prefix, which by default is every word.
+	 */
+	Iterator iterator(string prefix = "") const;
 
 
 	/*
@@ -175,6 +347,17 @@ class Lexicon {
 	 */
     Lexicon(const Lexicon &rhs);
     const Lexicon & operator=(const Lexicon &rhs);
+
+	/*
+	 * Member function: swap
+	 * Usage: lex.swap(other);
+	 * -----------------------
+	 * This member function exchanges the contents of this lexicon with those
+	 * of other, in constant time. It is the way to move a lexicon without
+	 * copying it, e.g. into a SharedLexicon (see sharedlexicon.h), after
+	 * which the source lexicon is left empty.
+	 */
+	void swap(Lexicon &other);
               
                 
   private:
@@ -189,37 +372,340 @@ class Lexicon {
 
 	struct Edge {
 #if defined(BYTE_ORDER) && BYTE_ORDER == LITTLE_ENDIAN
-		unsigned long letter:5;
-		unsigned long lastEdge:1;
-		unsigned long accept:1;
-		unsigned long unused:1;
-		unsigned long children:24;
+		unsigned int letter:5;
+		unsigned int lastEdge:1;
+		unsigned int accept:1;
+		unsigned int unused:1;
+		unsigned int children:24;
 #else
-		unsigned long children:24;
-		unsigned long unused:1;
-		unsigned long accept:1;
-		unsigned long lastEdge:1;
-		unsigned long letter:5;
+		unsigned int children:24;
+		unsigned int unused:1;
+		unsigned int accept:1;
+		unsigned int lastEdge:1;
+		unsigned int letter:5;
 #endif
 	};
-	
+
+	/* The edges are the form the dawg is saved in, but searches use a
+	 * second array built from them, with one node for each edge: node i is
+	 * where you are after following edge i, and node 0 (edge 0 is never
+	 * followed) is the start. A node is two 32-bit words. The first has a
+	 * bit for each letter that leads on from the node (bit 0 for 'a'), plus
+	 * the accept bit; the second is the index of the node for the first of
+	 * those letters, the others following in alphabetical order. So the
+	 * child for a letter is found by counting the bits below it, with no
+	 * walk along the siblings. The array starts on a cache line boundary.
+	 *
+	 * Word indexes are worked out from a second array, kept apart from the
+	 * nodes so that searches that don't need them touch no more memory.
+	 * The dawg words are numbered in alphabetical order, so the index of a
+	 * word is the number of words before it. Going from a node to a child
+	 * passes the node's own word, if it ends one, and every word down the
+	 * child's earlier siblings; wordsBefore holds that second count for
+	 * each node, so adding up along the path gives the index. Since it
+	 * only depends on the run a node is in, sharing suffixes is no problem.
+	 */
+	struct Node {
+		unsigned int mask;			// NODE_LETTERS bits, plus NODE_ACCEPT
+		unsigned int children;		// node for the lowest letter in mask
+	};
+	enum { NODE_LETTERS = (1u << 26) - 1, NODE_ACCEPT = 1u << 31, NODE_ALIGNMENT = 64 };
+
     Edge *edges, *start;
     int numEdges, numDawgWords;
-    std::set<string> otherWords;
+    Node *nodes;				// numEdges of them, NULL if there are no edges
+    unsigned int *wordsBefore;	// for each node, the words reached through its earlier siblings
+    char *nodeStorage;			// what nodes was allocated in, NULL if it's mapped
+    const void *mapping;		// non-NULL if edges point into a mapped native file (see MapReadOnlyFile)
+    long mappingLength;
+
+	/* Words added at runtime go in a trie rather than the dawg, which can't
+	 * be changed once built. Each node has the letter on the way into it,
+	 * whether a word ends there, and links to its first child and its next
+	 * sibling; siblings are kept in alphabetical order. Node 0 is the root,
+	 * so 0 never appears as a child or sibling and a 0 link means none.
+	 */
+	struct TrieNode {
+		int firstChild;
+		int nextSibling;
+		char letter;
+		bool accept;
+		int parent;
+		int wordIndex;		// counted from the first trie word, -1 if accept is false
+	};
 
-    Edge *findEdgeForChar(Edge *children, char ch);
-    Edge *traceToLastEdge(const string & s);
+    std::vector<TrieNode> otherWords;	// empty until a word is added
+    std::vector<int> otherWordNodes;	// node for each trie word, by wordIndex
+    int numOtherWords;
+
+    int findChildNode(int node, char ch) const;
+    static int countBits(unsigned int mask);
+    int traceNodes(const string & s) const;
+    void buildNodes();
+    int countWordsBefore();
+    int recCountWords(int node, std::vector<int> & counts) const;
+    unsigned int recExtract(int node, int trieNode, unsigned int allowed, int counts[], const unsigned int follows[],
+                            std::vector<Edge> & outEdges, std::vector<Node> & outNodes) const;
+    void allocateNodes();
     void readBinaryFile(string filename);
+    void readNativeFile(string filename);
+    void releaseEdges();
+    void loadEdges(const std::vector<unsigned int> & packed, int startIndex);
+    void writeDawgFile(string filename, bool native) const;
+    int findTrieChild(int node, char ch) const;
+    int traceTrie(const string & s) const;
+	template <typename VisitorType>
+	  void recVisitDawg(int node, string & soFar, VisitorType & visitor) const;
+	template <typename VisitorType>
+	  void recVisitTrie(int node, string & soFar, VisitorType & visitor) const;
+	static string lowerCase(string s);
+
+	// Calls a mapAll callback from visitWords.
 	template <typename ClientDataType>
-	  void recMapAll(Edge *edge, bool first, string soFar, void (fn)(string, ClientDataType &), ClientDataType &data);
+	  struct mapAllVisitorT {
+		void (*fn)(string word, ClientDataType &);
+		ClientDataType *data;
+		void operator()(const string & word) { fn(word, *data); }
+	};
 
-	unsigned int charToOrd(char ch) { return ((unsigned int)(tolower(ch) - 'a' + 1)); }
-    char ordToChar(unsigned int ord) { return ((char)(ord - 1 + 'a')); }
+	unsigned int charToOrd(char ch) const { return ((unsigned int)(tolower(ch) - 'a' + 1)); }
+    char ordToChar(unsigned int ord) const { return ((char)(ord - 1 + 'a')); }
     void copyContentsFrom(const Lexicon &rhs);
-	
+
+    friend class Cursor;
+    friend class Iterator;
+};
+
+
+class Lexicon::Cursor {
+
+  public:
+
+   /*
+    * Constructor: Cursor
+    * Usage: Lexicon::Cursor cur;
+    * ---------------------------
+    * The default constructor makes a cursor that matches nothing. Use the
+    * lexicon's cursor member function to get a cursor that can be advanced.
+    */
+    Cursor();
+
+   /*
+    * Member function: advance
+    * Usage: if (cur.advance(ch))...
+    * ------------------------------
+    * This member function extends the cursor's prefix by the given letter
+    * (case-insensitively). It returns true if some word in the lexicon
+    * begins with the extended prefix, false otherwise. Once advance has
+    * returned false, the cursor stays dead and matches nothing.
+    */
+    bool advance(char ch);
+
+   /*
+    * Member function: isWord
+    * Usage: if (cur.isWord())...
+    * ---------------------------
+    * This member function returns true if the prefix traced so far is
+    * itself a word in the lexicon.
+    */
+    bool isWord();
+
+   /*
+    * Member function: wordIndex
+    * Usage: int index = cur.wordIndex();
+    * -----------------------------------
+    * This member function returns the index (see Lexicon::indexOf) of the
+    * prefix traced so far, or -1 if it isn't a word. The index is worked
+    * out a step at a time as the cursor advances, so this costs no more
+    * than isWord.
+    */
+    int wordIndex();
+
+   /*
+    * Member function: length
+    * Usage: if (cur.length() >= 4)...
+    * --------------------------------
+    * This member function returns the number of letters traced so far.
+    */
+    int length() { return depth; }
+
+   /*
+    * Member function: hasChildren
+    * Usage: if (cur.hasChildren())...
+    * --------------------------------
+    * This member function returns true if some word in the lexicon is
+    * strictly longer than, and begins with, the prefix traced so far.
+    * There is no point advancing a cursor for which this returns false.
+    */
+    bool hasChildren();
+
+   /*
+    * Member function: nextLetters
+    * Usage: unsigned int letters = cur.nextLetters();
+    * ------------------------------------------------
+    * This member function returns the letters the cursor can be advanced
+    * by, one bit per letter with bit 0 for 'a', so a search can rule out
+    * all the wrong letters at once instead of trying each. It is 0 just
+    * when hasChildren is false, except for words with characters other
+    * than a to z, which it leaves out.
+    */
+    unsigned int nextLetters();
+
+  private:
+    friend class Lexicon;
+
+    const Lexicon *lex;	// NULL for a dead cursor
+    int node;			// node reached in the dawg, -1 once off the dawg
+    int depth;			// number of letters traced so far
+    int trieNode;		// node reached in the trie of other words, -1 once off the trie
+    int dawgIndex;		// index of the first dawg word at or after the prefix
 };
 
 
+class Lexicon::Iterator {
+
+  public:
+
+   /*
+    * Member functions: hasNext, next
+    * Usage: while (itr.hasNext()) word = itr.next();
+    * -----------------------------------------------
+    * hasNext returns true if there are words left, and next returns the
+    * next of them, calling Error if there are none. The word returned is
+    * only good until hasNext or next is called again.
+    */
+    bool hasNext();
+    const string & next();
+
+  private:
+    friend class Lexicon;
+
+    // A node on the way down to the current word, and where to go next
+    // from it: the letters of its dawg children not yet visited, or its
+    // next trie child, 0 once there are no more.
+    struct frameT {
+        int node;
+        unsigned int letters;
+        int child;
+    };
+
+    const Lexicon *lex;
+    string word;					// the letters of the path to the top frame
+    int prefixLength;
+    std::vector<frameT> path;		// empty once the current part is finished
+    bool inTrie;					// walking the trie of other words rather than the dawg
+    int trieStart;					// the trie node for the prefix, -1 if none
+    bool entered;					// the top frame was just reached, so its word comes next
+    bool haveWord;					// word holds a word next hasn't returned yet
+
+    void enterTrie();
+    bool findWord();
+};
+
+
+/*
+ * The cursor operations are the innermost step of any search that uses
+ * them, so they are defined inline here rather than in lexicon.cpp.
+ */
+
+inline Lexicon::Cursor Lexicon::cursor() const
+{
+	Cursor cur;
+	cur.lex = this;
+	cur.node = nodes ? 0 : -1;
+	cur.trieNode = otherWords.empty() ? -1 : 0;
+	cur.dawgIndex = 0;
+	return cur;
+}
+
+inline Lexicon::Cursor::Cursor()
+{
+	lex = NULL;
+	node = -1;
+	depth = 0;
+	trieNode = -1;
+	dawgIndex = 0;
+}
+
+inline bool Lexicon::Cursor::advance(char ch)
+{
+	if (!lex) return false;
+	if (node != -1) {
+		int child = lex->findChildNode(node, ch);
+		if (child != -1)
+			dawgIndex += ((lex->nodes[node].mask & NODE_ACCEPT) ? 1 : 0) + lex->wordsBefore[child];
+		node = child;
+	}
+	if (trieNode != -1)
+		trieNode = lex->findTrieChild(trieNode, ch);
+	depth++;
+	if (node == -1 && trieNode == -1) lex = NULL;	// dead end, nothing can match from here on
+	return lex != NULL;
+}
+
+inline bool Lexicon::Cursor::isWord()
+{
+	if (!lex) return false;
+	if (node != -1 && (lex->nodes[node].mask & NODE_ACCEPT)) return true;
+	return trieNode != -1 && lex->otherWords[trieNode].accept;
+}
+
+inline int Lexicon::Cursor::wordIndex()
+{
+	if (!lex) return -1;
+	if (node != -1 && (lex->nodes[node].mask & NODE_ACCEPT)) return dawgIndex;
+	if (trieNode != -1 && lex->otherWords[trieNode].accept)
+		return lex->numDawgWords + lex->otherWords[trieNode].wordIndex;
+	return -1;
+}
+
+inline bool Lexicon::Cursor::hasChildren()
+{
+	if (!lex) return false;
+	if (node != -1 && (lex->nodes[node].mask & NODE_LETTERS)) return true;
+	return trieNode != -1 && lex->otherWords[trieNode].firstChild != 0;
+}
+
+inline unsigned int Lexicon::Cursor::nextLetters()
+{
+	if (!lex) return 0;
+	unsigned int letters = (node != -1) ? lex->nodes[node].mask & NODE_LETTERS : 0;
+	if (trieNode != -1) {
+		for (int child = lex->otherWords[trieNode].firstChild; child != 0; child = lex->otherWords[child].nextSibling) {
+			unsigned int ord = lex->charToOrd(lex->otherWords[child].letter) - 1;
+			if (ord < 26) letters |= 1u << ord;
+		}
+	}
+	return letters;
+}
+
+// Counts the bits set in a node's mask, which is also the rank of a letter
+// among its siblings once the higher letters are masked off.
+inline int Lexicon::countBits(unsigned int mask)
+{
+#if defined(__GNUC__)
+	return __builtin_popcount(mask);
+#else
+	mask = mask - ((mask >> 1) & 0x55555555);
+	mask = (mask & 0x33333333) + ((mask >> 2) & 0x33333333);
+	return (((mask + (mask >> 4)) & 0x0f0f0f0f) * 0x01010101) >> 24;
+#endif
+}
+
+// Returns the child of a dawg node for the given char, or -1 if there is
+// none. This is the innermost step of every search, so it is one mask test
+// and a bit count whatever the number of siblings.
+inline int Lexicon::findChildNode(int node, char ch) const
+{
+	unsigned int ord = charToOrd(ch) - 1;	// wraps around for anything before 'a'
+	if (ord >= 26) return -1;
+	unsigned int bit = 1u << ord;
+	unsigned int mask = nodes[node].mask;
+	if (!(mask & bit)) return -1;
+	return nodes[node].children + countBits(mask & (bit - 1));
+}
+
+
 /* 
  * Because of the way C++ templates are compiled, we must put the implementation for
  * the mapping operation here in the header file. This is a bit quirky and seems to 
@@ -229,32 +715,59 @@ class Lexicon {
  */
 
 
-template <typename ClientDataType>
-  void Lexicon::recMapAll(Edge *edge, bool first, string soFar, void (fn)(string word, ClientDataType &), ClientDataType &clientData)
+// Visits the words at or below a dawg node, soFar holding the letters
+// on the way to it.
+template <typename VisitorType>
+  void Lexicon::recVisitDawg(int node, string & soFar, VisitorType & visitor) const
 	{
-		if (!edge) return;
-		Edge *curEdge;
-		if (first) {
-			curEdge = edge;
-		} else {
-			soFar += ordToChar(edge->letter);
-			if (edge->accept) fn(soFar, clientData);
-			if (!edge->children) return;
-			curEdge = &edges[edge->children];
+		if (nodes[node].mask & NODE_ACCEPT) visitor(soFar);
+		int child = nodes[node].children;
+		for (unsigned int letters = nodes[node].mask & NODE_LETTERS; letters != 0; letters &= letters - 1) {
+			soFar += char('a' + countBits((letters & (0 - letters)) - 1));
+			recVisitDawg(child++, soFar, visitor);
+			soFar.erase(soFar.length() - 1);
 		}
-		while (true) {
-			recMapAll(curEdge, false, soFar, fn, clientData);
-			if (curEdge->lastEdge) break;
-			curEdge++;
+	}
+
+// Visits the words at or below a trie node, soFar holding the letters
+// on the way to it, its own included.
+template <typename VisitorType>
+  void Lexicon::recVisitTrie(int node, string & soFar, VisitorType & visitor) const
+	{
+		if (otherWords[node].accept) visitor(soFar);
+		for (int child = otherWords[node].firstChild; child != 0; child = otherWords[child].nextSibling) {
+			soFar += otherWords[child].letter;
+			recVisitTrie(child, soFar, visitor);
+			soFar.erase(soFar.length() - 1);
 		}
 	}
-	
+
+template <typename VisitorType>
+  VisitorType Lexicon::visitWords(string prefix, VisitorType visitor) const
+	{
+		string soFar = lowerCase(prefix);
+		int node = traceNodes(soFar);
+		if (node != -1)
+			recVisitDawg(node, soFar, visitor);		// visit dawg
+		node = traceTrie(soFar);
+		if (node != -1)
+			recVisitTrie(node, soFar, visitor);		// visit other words, in alphabetical order
+		return visitor;
+	}
+
+template <typename VisitorType>
+  VisitorType Lexicon::visitWords(VisitorType visitor) const
+	{
+		return visitWords("", visitor);
+	}
+
 template <typename ClientDataType>
-  void Lexicon::mapAll(void (fn)(string word, ClientDataType &), ClientDataType &clientData)
+  void Lexicon::mapAll(void (fn)(string word, ClientDataType &), ClientDataType &clientData) const
 	{
-		recMapAll(start, true, "", fn, clientData);	// map over dawg
-		for (set<string>::iterator itr = otherWords.begin(); itr != otherWords.end(); itr++)
-			fn(*itr, clientData);					// map over other set
+		mapAllVisitorT<ClientDataType> visitor;
+		visitor.fn = fn;
+		visitor.data = &clientData;
+		visitWords(visitor);
 	}
 
 #endif
\ No newline at end of file
@@ -0,0 +1,94 @@
+/*
+ * File: lexiconcompiler.cpp
+ * -------------------------
+ * A command-line tool that compiles word lists into lexicon files. Each
+ * input can be a plain text file of words, one per line, or a lexicon file
+ * in either binary format; the words of all the inputs are merged and
+ * written to the output as one dawg, in the portable DAWG format by
+ * default or, with -native, in the memory-mapped native format.
+ *
+ * Usage: lexiconcompiler [-native] -o output input ...
+ *
+ * For example, to add a few words to the standard lexicon:
+ *
+ *	lexiconcompiler -o lexicon.dat lexicon.dat extra.txt
+ *
+ * Case is ignored. Words with characters other than the letters a to z
+ * can't be held in a dawg; they are reported on standard error and left
+ * out. An input named - is read as text from standard input.
+ */
+
+#include "genlib.h"
+#include "consoletool.h"
+#include "lexicon.h"
+#include "dawgbuilder.h"
+#include <iostream>
+#include <cstdlib>
+
+
+/* Struct: mergeT
+ * --------------
+ * The lexicon the inputs are merged into, and the number of words that
+ * had to be left out of it.
+ */
+
+struct mergeT {
+	Lexicon lex;
+	int numSkipped;
+};
+
+static void MergeWord(string word, mergeT & merge)
+{
+	if (word.empty()) return;		// blank lines in text files
+	if (DawgBuilder::canHold(word)) {
+		merge.lex.add(word);
+	} else {
+		cerr << "lexiconcompiler: \"" << word << "\" isn't all letters, skipped" << endl;
+		merge.numSkipped++;
+	}
+}
+
+static void Usage()
+{
+	cerr << "Usage: lexiconcompiler [-native] -o output input ..." << endl;
+	exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+	bool native = false;
+	string output;
+	int arg = 1;
+	for (; arg < argc && argv[arg][0] == '-' && argv[arg][1] != '\0'; arg++) {
+		string flag = argv[arg];
+		if (flag == "-native") {
+			native = true;
+		} else if (flag == "-o" && arg + 1 < argc) {
+			output = argv[++arg];
+		} else {
+			Usage();
+		}
+	}
+	if (output.empty() || arg == argc) Usage();
+
+	mergeT merge;
+	merge.numSkipped = 0;
+	for (; arg < argc; arg++) {
+		string name = argv[arg];
+		if (name == "-") {
+			string line;
+			while (getline(cin, line))
+				MergeWord(line, merge);
+		} else {
+			Lexicon input(name);	// reads any of the formats, or calls Error
+			input.mapAll(MergeWord, merge);
+		}
+	}
+	merge.lex.compact();
+	if (native) merge.lex.writeNativeFile(output);
+	else merge.lex.writeBinaryFile(output);
+	cerr << "lexiconcompiler: wrote " << merge.lex.size() << " words to " << output;
+	if (merge.numSkipped > 0) cerr << ", skipped " << merge.numSkipped;
+	cerr << endl;
+	return 0;
+}
@@ -0,0 +1,62 @@
+/*
+ * File: mappedfile.cpp
+ * --------------------
+ * Implements MapReadOnlyFile with mmap, or by reading the file in where
+ * mmap isn't available.
+ */
+
+#include "mappedfile.h"
+#ifndef _MSC_VER
+#include <sys/mman.h>	// for mmap
+#include <fcntl.h>		// for open
+#include <unistd.h>		// for close
+#else
+#include <fstream>
+#endif
+
+#ifndef _MSC_VER
+
+const void *MapReadOnlyFile(string filename, long length)
+{
+	int fd = open(filename.c_str(), O_RDONLY);
+	void *base = (fd == -1) ? MAP_FAILED : mmap(NULL, length, PROT_READ, MAP_SHARED, fd, 0);
+	if (fd != -1) close(fd);	// the mapping stays valid after the descriptor is closed
+	return (base == MAP_FAILED) ? NULL : base;
+}
+
+void UnmapReadOnlyFile(const void *contents, long length)
+{
+	if (contents != NULL) munmap((void *)contents, length);
+}
+
+#else
+
+// The copy is put on a cache line boundary within a larger block, and
+// the byte just before it records how far in it starts, between 1 and
+// CONTENTS_ALIGNMENT, so the block can be found again to free it.
+static const int CONTENTS_ALIGNMENT = 64;
+
+const void *MapReadOnlyFile(string filename, long length)
+{
+	ifstream istr(filename.c_str(), ios::in|ios::binary);
+	if (istr.fail()) return NULL;
+	char *block = new char[length + CONTENTS_ALIGNMENT];
+	int offset = CONTENTS_ALIGNMENT - (size_t)block % CONTENTS_ALIGNMENT;
+	char *contents = block + offset;
+	contents[-1] = (char)offset;
+	istr.read(contents, length);
+	if (istr.fail()) {
+		delete[] block;
+		return NULL;
+	}
+	return contents;
+}
+
+void UnmapReadOnlyFile(const void *contents, long length)
+{
+	if (contents == NULL) return;
+	const char *bytes = (const char *)contents;
+	delete[] (bytes - (unsigned char)bytes[-1]);
+}
+
+#endif
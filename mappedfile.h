@@ -0,0 +1,37 @@
+/*
+ * File: mappedfile.h
+ * ------------------
+ * Defines functions for reading a whole file in place, by mapping it into
+ * memory, for the readers of the native lexicon and catalog formats.
+ */
+
+#ifndef _mappedfile_h
+#define _mappedfile_h
+
+#include "genlib.h"
+
+
+/*
+ * Function: MapReadOnlyFile
+ * Usage: const void *contents = MapReadOnlyFile(filename, length);
+ * ----------------------------------------------------------------
+ * This function maps the first length bytes of a file into memory,
+ * read-only and shared, so every process reading the same file uses the
+ * same pages, and returns where they start, or NULL if the file can't
+ * be opened or mapped. The start is on a page boundary, so it is aligned
+ * for anything up to a cache line. Where there is no mmap, the bytes are
+ * read into memory of their own instead, with the same alignment.
+ */
+const void *MapReadOnlyFile(string filename, long length);
+
+
+/*
+ * Function: UnmapReadOnlyFile
+ * Usage: UnmapReadOnlyFile(contents, length);
+ * -------------------------------------------
+ * This function releases what MapReadOnlyFile returned, given the same
+ * length.
+ */
+void UnmapReadOnlyFile(const void *contents, long length);
+
+#endif
@@ -0,0 +1,93 @@
+/*
+ * File: sharedlexicon.cpp
+ * -----------------------
+ * Implements the SharedLexicon class. Each shared lexicon carries its own
+ * reference count, and the lexicons loaded from files are kept in a table
+ * by file name that itself holds one reference to each, so they stay
+ * loaded for the life of the process.
+ */
+
+#include "sharedlexicon.h"
+#include <map>
+
+
+static std::map<string, SharedLexicon> loaded;
+static pthread_mutex_t loadedLock = PTHREAD_MUTEX_INITIALIZER;
+
+// The table lock is held while the file is read, so two threads asking
+// for the same new file at once don't both read it.
+SharedLexicon SharedLexicon::load(string filename)
+{
+	pthread_mutex_lock(&loadedLock);
+	std::map<string, SharedLexicon>::iterator found = loaded.find(filename);
+	if (found == loaded.end()) {
+		try {
+			Lexicon words(filename);
+			found = loaded.insert(std::make_pair(filename, SharedLexicon(words))).first;
+		} catch (...) {
+			pthread_mutex_unlock(&loadedLock);
+			throw;
+		}
+	}
+	SharedLexicon result = found->second;
+	pthread_mutex_unlock(&loadedLock);
+	return result;
+}
+
+SharedLexicon::SharedLexicon()
+{
+	shared = newShared();
+}
+
+SharedLexicon::SharedLexicon(Lexicon & words)
+{
+	shared = newShared();
+	shared->lex.swap(words);
+}
+
+SharedLexicon::SharedLexicon(const SharedLexicon & rhs)
+{
+	shared = rhs.shared;
+	retain();
+}
+
+const SharedLexicon & SharedLexicon::operator=(const SharedLexicon & rhs)
+{
+	if (shared != rhs.shared) {
+		release();
+		shared = rhs.shared;
+		retain();
+	}
+	return *this;
+}
+
+SharedLexicon::~SharedLexicon()
+{
+	release();
+}
+
+SharedLexicon::sharedT *SharedLexicon::newShared()
+{
+	sharedT *s = new sharedT;
+	s->refCount = 1;
+	pthread_mutex_init(&s->lock, NULL);
+	return s;
+}
+
+void SharedLexicon::retain()
+{
+	pthread_mutex_lock(&shared->lock);
+	shared->refCount++;
+	pthread_mutex_unlock(&shared->lock);
+}
+
+void SharedLexicon::release()
+{
+	pthread_mutex_lock(&shared->lock);
+	bool last = (--shared->refCount == 0);
+	pthread_mutex_unlock(&shared->lock);
+	if (last) {
+		pthread_mutex_destroy(&shared->lock);
+		delete shared;
+	}
+}
@@ -0,0 +1,86 @@
+/*
+ * File: sharedlexicon.h
+ * ---------------------
+ * Defines the SharedLexicon class, a handle through which any number of
+ * games, threads or sessions can use one loaded lexicon.
+ */
+
+#ifndef _sharedlexicon_h
+#define _sharedlexicon_h
+
+#include "genlib.h"
+#include "lexicon.h"
+#include <pthread.h>
+
+
+/*
+ * Class: SharedLexicon
+ * --------------------
+ * A SharedLexicon refers to a lexicon that can no longer be changed.
+ * Copying a handle is cheap: the copy refers to the same lexicon, which
+ * is freed once the last handle to it goes away. Handles may be copied
+ * and destroyed from different threads at once, and since the lexicon
+ * is read-only, any number of threads can search it at the same time.
+ * Loading through SharedLexicon::load reads each file only once per
+ * process, however many times it is asked for:
+ *
+ *	SharedLexicon lex = SharedLexicon::load("lexicon.dat");
+ *	if (lex->containsWord("happy"))
+ *		...
+ */
+
+class SharedLexicon {
+
+  public:
+
+   /*
+    * Static member function: load
+    * Usage: SharedLexicon lex = SharedLexicon::load("lexicon.dat");
+    * --------------------------------------------------------------
+    * This function returns a handle to the lexicon read from the given
+    * file. The first call for a file reads it, as the Lexicon constructor
+    * does; later calls return the same lexicon without reading it again.
+    */
+    static SharedLexicon load(string filename);
+
+   /*
+    * Constructor: SharedLexicon
+    * Usage: SharedLexicon lex;
+    *        SharedLexicon lex(words);
+    * --------------------------------
+    * The default constructor makes a handle to an empty lexicon. The second
+    * form moves the contents of an existing lexicon into a new shared one
+    * (using Lexicon::swap, so nothing is copied), leaving words empty.
+    */
+    SharedLexicon();
+    explicit SharedLexicon(Lexicon & words);
+
+    SharedLexicon(const SharedLexicon & rhs);
+    const SharedLexicon & operator=(const SharedLexicon & rhs);
+    ~SharedLexicon();
+
+   /*
+    * Operators: *, ->
+    * Usage: if (lex->containsWord(word))...
+    *        SolveBoard(board, *lex, wordsSeen, found);
+    * -------------------------------------------------
+    * These give read-only access to the shared lexicon.
+    */
+    const Lexicon & operator*() const { return shared->lex; }
+    const Lexicon * operator->() const { return &shared->lex; }
+
+  private:
+    struct sharedT {
+        Lexicon lex;
+        int refCount;
+        pthread_mutex_t lock;	// guards refCount
+    };
+
+    sharedT *shared;
+
+    static sharedT *newShared();
+    void retain();
+    void release();
+};
+
+#endif
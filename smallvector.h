@@ -0,0 +1,113 @@
+/*
+ * File: smallvector.h
+ * -------------------
+ * Defines the SmallVector class template, a vector that keeps its first
+ * elements inside itself.
+ */
+
+#ifndef _smallvector_h
+#define _smallvector_h
+
+#include "genlib.h"
+
+
+/*
+ * Class: SmallVector
+ * ------------------
+ * A small vector holds up to N elements in an array of its own, so
+ * making one, filling it and throwing it away allocates nothing as long
+ * as it stays that short; only adding the element after that moves the
+ * elements to the heap, doubling the room each time it runs out. It is
+ * meant for short lists made often, like the cells of a path, which
+ * always fit: a SmallVector<int, BigBoard::NUM_CELLS> holds any path on
+ * any board. There is no bounds checking. Sample use:
+ *
+ *	SmallVector<int, BigBoard::NUM_CELLS> path;
+ *	path.add(cell);
+ *	for (int i = 0; i < path.size(); i++) ... path[i] ...
+ *
+ * ElemType must have a default constructor and be assignable.
+ */
+
+template <typename ElemType, int N>
+  class SmallVector {
+
+  public:
+
+    SmallVector()
+    {
+        elems = inlineElems;
+        count = 0;
+        capacity = N;
+    }
+
+    SmallVector(const SmallVector & other)
+    {
+        elems = inlineElems;
+        count = 0;
+        capacity = N;
+        copyFrom(other);
+    }
+
+    SmallVector & operator=(const SmallVector & other)
+    {
+        if (this != &other) {
+            count = 0;
+            copyFrom(other);
+        }
+        return *this;
+    }
+
+    ~SmallVector() { if (elems != inlineElems) delete[] elems; }
+
+   /*
+    * Member functions: size, isEmpty, operator[]
+    * Usage: int cell = path[i];
+    * --------------------------
+    * These member functions give the number of elements, whether there
+    * are none, and the i-th one, which can be assigned to.
+    */
+    int size() const { return count; }
+    bool isEmpty() const { return count == 0; }
+    ElemType & operator[](int i) { return elems[i]; }
+    const ElemType & operator[](int i) const { return elems[i]; }
+
+   /*
+    * Member functions: add, clear
+    * Usage: path.add(cell);
+    * ----------------------
+    * add appends an element, and clear removes them all, keeping the
+    * room they took for the elements to come.
+    */
+    void add(const ElemType & elem)
+    {
+        if (count == capacity) grow(capacity * 2);
+        elems[count++] = elem;
+    }
+    void clear() { count = 0; }
+
+  private:
+    ElemType inlineElems[N];
+    ElemType *elems;			// inlineElems until there are more than N
+    int count, capacity;
+
+    void grow(int newCapacity)
+    {
+        ElemType *bigger = new ElemType[newCapacity];
+        for (int i = 0; i < count; i++)
+            bigger[i] = elems[i];
+        if (elems != inlineElems) delete[] elems;
+        elems = bigger;
+        capacity = newCapacity;
+    }
+
+    void copyFrom(const SmallVector & other)
+    {
+        if (other.count > capacity) grow(other.count);
+        for (int i = 0; i < other.count; i++)
+            elems[i] = other.elems[i];
+        count = other.count;
+    }
+};
+
+#endif
@@ -0,0 +1,109 @@
+/*
+ * File: solutioncache.cpp
+ * -----------------------
+ * Implements the SolutionCache class template. Symmetry s of a board
+ * moves the cube on each cell c to SymmetricCell(s, c), and the key of a
+ * board is its letters after whichever symmetry puts them first in
+ * alphabetical order. Two arrangements of the same cubes share a key,
+ * and a path on the arrangement an entry was solved for is carried over
+ * to another one by way of the canonical board, which the two
+ * arrangements' symmetries both lead to.
+ */
+
+#include "solutioncache.h"
+
+
+template <typename BoardType>
+  SolutionCache<BoardType>::SolutionCache(int capacity)
+{
+	if (BoardType::NUM_ROWS != BoardType::NUM_COLS)
+		Error("SolutionCache only works with square boards");
+	if (capacity < 1)
+		Error("SolutionCache must be able to hold at least one board");
+	maxEntries = capacity;
+	numHits = numMisses = 0;
+}
+
+template <typename BoardType>
+  void SolutionCache<BoardType>::clear()
+{
+	entries.clear();
+	lookup.clear();
+	numHits = numMisses = 0;
+}
+
+// Returns where symmetry moves a cell: symmetries 0 to 3 turn the board
+// a quarter turn clockwise that many times, and 4 to 7 do the same after
+// flipping it left to right.
+template <typename BoardType>
+  int SolutionCache<BoardType>::SymmetricCell(int symmetry, int cell)
+{
+	int n = BoardType::NUM_ROWS;
+	int row = BoardType::rowOf(cell), col = BoardType::colOf(cell);
+	if (symmetry >= 4) col = n - 1 - col;
+	for (int i = 0; i < symmetry % 4; i++) {
+		int turned = row;
+		row = col;
+		col = n - 1 - turned;
+	}
+	return BoardType::cellAt(row, col);
+}
+
+// Returns the key for a board, setting symmetry to the one that takes
+// the board to it.
+template <typename BoardType>
+  string SolutionCache<BoardType>::CanonicalForm(const BoardType & board, int & symmetry)
+{
+	string key;
+	for (int s = 0; s < NUM_SYMMETRIES; s++) {
+		string letters(BoardType::NUM_CELLS, ' ');
+		for (int cell = 0; cell < BoardType::NUM_CELLS; cell++)
+			letters[SymmetricCell(s, cell)] = board.letterAt(cell);
+		if (s == 0 || letters < key) {
+			key = letters;
+			symmetry = s;
+		}
+	}
+	return key;
+}
+
+template <typename BoardType>
+  void SolutionCache<BoardType>::solve(const BoardType & board, const Lexicon & lex, ThreadPool & pool,
+									   SolutionIndex<BoardType> & solution)
+{
+	int symmetry;
+	string key = CanonicalForm(board, symmetry);
+	if (!lookup.containsKey(key)) {
+		numMisses++;
+		solution.build(board, lex, pool);
+		if (entries.size() == maxEntries) {
+			lookup.remove(entries.back().key);
+			entries.pop_back();
+		}
+		entryT entry;
+		entry.key = key;
+		entry.symmetry = symmetry;
+		entry.solution = solution;
+		entries.push_front(entry);
+		lookup.add(key, entries.begin());
+		return;
+	}
+	numHits++;
+	entryIterT found = lookup[key];
+	entries.splice(entries.begin(), entries, found);		// now the most recently used; iterators stay good
+	solution = found->solution;
+	if (found->symmetry != symmetry) {
+		int toCanonical[BoardType::NUM_CELLS], cellMap[BoardType::NUM_CELLS];
+		for (int cell = 0; cell < BoardType::NUM_CELLS; cell++)
+			toCanonical[SymmetricCell(symmetry, cell)] = cell;		// undoes this board's symmetry
+		for (int cell = 0; cell < BoardType::NUM_CELLS; cell++)
+			cellMap[cell] = toCanonical[SymmetricCell(found->symmetry, cell)];
+		solution.mapCells(cellMap);
+	}
+}
+
+
+// Compiled for the board sizes in board.h (see StandardBoard).
+
+template class SolutionCache<StandardBoard>;
+template class SolutionCache<BigBoard>;
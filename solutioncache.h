@@ -0,0 +1,108 @@
+/*
+ * File: solutioncache.h
+ * ---------------------
+ * Defines the SolutionCache class template, which keeps the solutions of
+ * recently solved boards so that a board seen again, in any of its
+ * rotations or reflections, doesn't have to be solved again.
+ */
+
+#ifndef _solutioncache_h
+#define _solutioncache_h
+
+#include "genlib.h"
+#include "board.h"
+#include "lexicon.h"
+#include "map.h"
+#include "threadpool.h"
+#include "solutionindex.h"
+#include <list>
+
+
+/*
+ * Class: SolutionCache
+ * --------------------
+ * Turning a square board a quarter turn, or flipping it over, moves the
+ * cubes but keeps every pair of neighbors, so the board has the same
+ * words as before, traced along the moved cells. The cache files each
+ * solution under the board's canonical form: the letters of whichever
+ * of its 8 arrangements comes first alphabetically. Every arrangement
+ * of a board then finds the same entry, whose paths are renumbered to
+ * suit the board asked about. Entries are kept in the order they were
+ * last used, and once the cache holds its capacity the least recently
+ * used one is dropped to make room. Sample use:
+ *
+ *	SolutionCache<StandardBoard> cache(100);
+ *	SolutionIndex<StandardBoard> solution;
+ *	cache.solve(board, lex, pool, solution);
+ *
+ * A board solved again in the arrangement it was first solved in gets
+ * exactly what solving it would give. One of its other arrangements
+ * gets the same words and scores, and paths that trace them there, but
+ * in the order the first arrangement found them. Every entry was solved
+ * against the lexicon given at the time, so the cache must be cleared
+ * if the lexicon changes. A cache is not safe to use from more than one
+ * thread at once. The template is compiled for StandardBoard and
+ * BigBoard in solutioncache.cpp.
+ */
+
+template <typename BoardType>
+  class SolutionCache {
+
+  public:
+
+    enum { NUM_SYMMETRIES = 8 };
+
+   /*
+    * Constructor: SolutionCache
+    * Usage: SolutionCache<BigBoard> cache(capacity);
+    * -----------------------------------------------
+    * The constructor makes an empty cache that holds up to capacity
+    * boards, which must be at least 1.
+    */
+    SolutionCache(int capacity);
+
+   /*
+    * Member function: solve
+    * Usage: cache.solve(board, lex, pool, solution);
+    * -----------------------------------------------
+    * This member function fills solution with the words on the board, as
+    * SolutionIndex::build would, by copying the board's entry if there is
+    * one and otherwise by solving it on the pool and adding it.
+    */
+    void solve(const BoardType & board, const Lexicon & lex, ThreadPool & pool, SolutionIndex<BoardType> & solution);
+
+   /*
+    * Member functions: size, capacity, hits, misses, clear
+    * Usage: cout << cache.hits() << " of " << cache.hits() + cache.misses();
+    * ----------------------------------------------------------------------
+    * These member functions return the number of boards held, the most
+    * that can be, and the number of calls to solve that reused an entry
+    * and that had to solve; clear empties the cache and resets the
+    * counts.
+    */
+    int size() const { return entries.size(); }
+    int capacity() const { return maxEntries; }
+    int hits() const { return numHits; }
+    int misses() const { return numMisses; }
+    void clear();
+
+  private:
+
+    // A solved board, with which arrangement of its canonical form it is.
+    struct entryT {
+        string key;
+        int symmetry;
+        SolutionIndex<BoardType> solution;
+    };
+    typedef typename std::list<entryT>::iterator entryIterT;
+
+    int maxEntries;
+    std::list<entryT> entries;		// the most recently used first
+    Map<entryIterT> lookup;			// each entry's place in entries, by key
+    int numHits, numMisses;
+
+    static int SymmetricCell(int symmetry, int cell);
+    static string CanonicalForm(const BoardType & board, int & symmetry);
+};
+
+#endif
@@ -0,0 +1,280 @@
+/*
+ * File: solutioncatalog.cpp
+ * -------------------------
+ * Implements the catalog format. A catalog file is a header followed by
+ * the records, each starting on a multiple of 4 bytes. Numbers in the
+ * headers are 32 bits in the order of the machine that wrote the file,
+ * which the header's byte order mark lets a reader check, as in the
+ * lexicon's native files; the record bodies are bytes and bits, so they
+ * read the same anywhere.
+ */
+
+#include "solutioncatalog.h"
+#include "bogglesolver.h"
+#include "strutils.h"
+#include "mappedfile.h"
+#include <algorithm>
+#include <cstddef>		// for offsetof
+#include <cstring>		// for memcpy, memset, strncmp
+
+static const char CATALOG_MAGIC[] = "BGSC";
+static const unsigned int CATALOG_VERSION = 1;
+static const unsigned int CATALOG_BYTE_ORDER_MARK = 0x01020304;
+static const int LEXICON_CHECK_WORDS = 64;		// words of the lexicon that go into its check
+static const int BITS_PER_CELL = 5;				// for paths and their lengths, enough for MAX_CELLS
+
+struct catalogHeaderT {
+	char magic[4];					// CATALOG_MAGIC, without the terminating null
+	unsigned int version;			// CATALOG_VERSION
+	unsigned int byteOrderMark;		// CATALOG_BYTE_ORDER_MARK as written by the saving machine
+	unsigned int numRecords;
+	unsigned int numLexiconWords;	// the size of the lexicon the word indexes are for
+	unsigned int lexiconCheck;		// and LexiconCheck of it
+};
+
+
+// Returns a hash of the lexicon's size and some of its words, spread
+// evenly through it, so a catalog read with some other lexicon is
+// almost sure to be noticed without hashing every word.
+static unsigned int LexiconCheck(const Lexicon & lex)
+{
+	unsigned int hash = 2166136261u;			// FNV-1a
+	string sample = IntegerToString(lex.size());
+	for (int i = 0; i < LEXICON_CHECK_WORDS && lex.size() > 0; i++)
+		sample += " " + lex.wordAt((long)i * lex.size() / LEXICON_CHECK_WORDS);
+	for (int i = 0; i < sample.length(); i++) {
+		hash ^= (unsigned char)sample[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+static void PutWord(std::vector<unsigned char> & bytes, int offset, unsigned int value)
+{
+	memcpy(&bytes[offset], &value, sizeof(value));
+}
+
+// Appends bits to a packed bit string, the lowest bit of value first.
+static void PutBits(std::vector<unsigned char> & bytes, long & bit, unsigned int value, int numBits)
+{
+	for (int i = 0; i < numBits; i++, bit++) {
+		if (bit % 8 == 0) bytes.push_back(0);
+		if ((value >> i) & 1) bytes.back() |= 1 << (bit % 8);
+	}
+}
+
+static unsigned int GetBits(const unsigned char *bytes, long & bit, int numBits)
+{
+	unsigned int value = 0;
+	for (int i = 0; i < numBits; i++, bit++)
+		value |= ((bytes[bit / 8] >> (bit % 8)) & 1) << i;
+	return value;
+}
+
+template <typename BoardType>
+  void EncodeSolutionRecord(const BoardType & board, catalogCubesT cubes, const Lexicon & lex,
+							const WordIndexSet & words, bool withPaths, std::vector<unsigned char> & record)
+{
+	typedef SolutionCatalog::Record R;
+	std::vector<int> sorted;
+	for (int i = 0; i < words.size(); i++)
+		sorted.push_back(words[i]);
+	std::sort(sorted.begin(), sorted.end());
+	record.assign(R::HEADER_SIZE, 0);
+	record[4] = BoardType::NUM_ROWS;
+	record[5] = BoardType::NUM_COLS;
+	record[6] = cubes;
+	record[7] = withPaths ? R::HAS_PATHS : 0;
+	PutWord(record, 8, sorted.size());
+	for (int cell = 0; cell < BoardType::NUM_CELLS; cell++)
+		record.push_back(board.letterAt(cell));
+	int indexesStart = record.size();
+	int previous = 0;
+	for (int i = 0; i < sorted.size(); i++) {
+		unsigned int delta = sorted[i] - previous;		// the first is from 0, the rest at least 1
+		for (; delta >= 0x80; delta >>= 7)
+			record.push_back(0x80 | (delta & 0x7f));
+		record.push_back(delta);
+		previous = sorted[i];
+	}
+	PutWord(record, 12, record.size() - indexesStart);
+	if (withPaths) {
+		long bit = 0;
+		int path[BoardType::NUM_CELLS];
+		for (int i = 0; i < sorted.size(); i++) {
+			string word = lex.wordAt(sorted[i]);
+			if (!FindWordPath(board, word, path))
+				Error("EncodeSolutionRecord was given " + word + ", which isn't on the board");
+			PutBits(record, bit, word.length(), BITS_PER_CELL);
+			for (int j = 0; j < word.length(); j++)
+				PutBits(record, bit, path[j], BITS_PER_CELL);
+		}
+	}
+	record.resize((record.size() + 3) / 4 * 4, 0);
+	PutWord(record, 0, record.size());
+}
+
+
+SolutionCatalogWriter::SolutionCatalogWriter(string filename, const Lexicon & lex)
+{
+	this->filename = filename;
+	out.open(filename.c_str(), ios::out|ios::binary|ios::trunc);
+	if (out.fail())
+		Error("Couldn't create catalog file " + filename);
+	catalogHeaderT header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, CATALOG_MAGIC, 4);
+	header.version = CATALOG_VERSION;
+	header.byteOrderMark = CATALOG_BYTE_ORDER_MARK;
+	header.numLexiconWords = lex.size();
+	header.lexiconCheck = LexiconCheck(lex);
+	out.write((char *)&header, sizeof(header));
+	numRecords = 0;
+	closed = false;
+}
+
+SolutionCatalogWriter::~SolutionCatalogWriter()
+{
+	if (!closed) close();
+}
+
+void SolutionCatalogWriter::add(const std::vector<unsigned char> & record)
+{
+	if (closed)
+		Error("SolutionCatalogWriter::add called after close");
+	out.write((const char *)&record[0], record.size());
+	numRecords++;
+}
+
+// The number of records is only known at the end, so it is written into
+// the header last.
+void SolutionCatalogWriter::close()
+{
+	closed = true;
+	unsigned int count = numRecords;
+	out.seekp(offsetof(catalogHeaderT, numRecords));
+	out.write((char *)&count, sizeof(count));
+	out.close();
+	if (out.fail())
+		Error("Couldn't write catalog file " + filename);
+}
+
+
+// Checks the header and maps the whole file.
+SolutionCatalog::SolutionCatalog(string filename)
+{
+	catalogHeaderT header;
+	ifstream istr(filename.c_str(), ios::in|ios::binary);
+	if (istr.fail())
+		Error("Couldn't open catalog file " + filename);
+	istr.read((char *)&header, sizeof(header));
+	istr.seekg(0, ios::end);
+	length = istr.tellg();
+	istr.close();
+	if (length < (long)sizeof(header) || strncmp(header.magic, CATALOG_MAGIC, 4) != 0)
+		Error("Improperly formed catalog file " + filename);
+	if (header.version != CATALOG_VERSION || header.byteOrderMark != CATALOG_BYTE_ORDER_MARK)
+		Error("Catalog file " + filename + " was saved by an incompatible program or machine");
+	numRecords = header.numRecords;
+	numLexiconWords = header.numLexiconWords;
+	lexiconCheck = header.lexiconCheck;
+	base = (const unsigned char *)MapReadOnlyFile(filename, length);
+	if (base == NULL)
+		Error("Couldn't map catalog file " + filename);
+	end = base + length;
+}
+
+SolutionCatalog::~SolutionCatalog()
+{
+	UnmapReadOnlyFile(base, length);
+}
+
+bool SolutionCatalog::matchesLexicon(const Lexicon & lex) const
+{
+	return lex.size() == numLexiconWords && LexiconCheck(lex) == lexiconCheck;
+}
+
+SolutionCatalog::Record SolutionCatalog::firstRecord() const
+{
+	return recordAt(base + sizeof(catalogHeaderT));
+}
+
+SolutionCatalog::Record SolutionCatalog::nextRecord(const Record & record) const
+{
+	if (!record.isValid())
+		Error("SolutionCatalog::nextRecord called with no record");
+	return recordAt(record.data + record.size());
+}
+
+// Returns the record at data, checking that it fits in what is left of
+// the file, or an invalid record if the file ends there.
+SolutionCatalog::Record SolutionCatalog::recordAt(const unsigned char *data) const
+{
+	if (data == end) return Record(NULL);
+	Record record(data);
+	long left = end - data;
+	if (left < Record::HEADER_SIZE || record.size() > left || record.size() % 4 != 0
+		|| record.numRows() * record.numCols() > MAX_CELLS
+		|| Record::HEADER_SIZE + record.numRows() * record.numCols() + Record::readWord(data + 12) > record.size())
+		Error("Improperly formed catalog record");
+	return record;
+}
+
+
+unsigned int SolutionCatalog::Record::readWord(const unsigned char *bytes)
+{
+	unsigned int value;
+	memcpy(&value, bytes, sizeof(value));
+	return value;
+}
+
+unsigned int SolutionCatalog::Record::size() const
+{
+	return readWord(data);
+}
+
+int SolutionCatalog::Record::numWords() const
+{
+	return readWord(data + 8);
+}
+
+SolutionCatalog::WordCursor SolutionCatalog::Record::words() const
+{
+	WordCursor cursor;
+	cursor.indexes = data + HEADER_SIZE + numRows() * numCols();
+	cursor.paths = hasPaths() ? cursor.indexes + readWord(data + 12) : NULL;
+	cursor.pathBit = 0;
+	cursor.wordsLeft = numWords();
+	cursor.index = 0;
+	cursor.length = 0;
+	return cursor;
+}
+
+
+int SolutionCatalog::WordCursor::next()
+{
+	if (wordsLeft == 0)
+		Error("SolutionCatalog::WordCursor::next called with no words left");
+	wordsLeft--;
+	unsigned int delta = 0;
+	for (int shift = 0; ; shift += 7) {
+		unsigned char byte = *indexes++;
+		delta |= (unsigned int)(byte & 0x7f) << shift;
+		if (!(byte & 0x80)) break;
+	}
+	index += delta;
+	if (paths != NULL) {
+		length = GetBits(paths, pathBit, BITS_PER_CELL);
+		for (int i = 0; i < length; i++)
+			path[i] = GetBits(paths, pathBit, BITS_PER_CELL);
+	}
+	return index;
+}
+
+
+// Compiled for the board sizes in board.h (see StandardBoard).
+
+template void EncodeSolutionRecord(const StandardBoard &, catalogCubesT, const Lexicon &, const WordIndexSet &, bool,
+								   std::vector<unsigned char> &);
+template void EncodeSolutionRecord(const BigBoard &, catalogCubesT, const Lexicon &, const WordIndexSet &, bool,
+								   std::vector<unsigned char> &);
@@ -0,0 +1,291 @@
+/*
+ * File: solutioncatalog.h
+ * -----------------------
+ * Defines a compact binary format for storing the solutions of many
+ * boards, with a writer that builds catalog files and a reader that maps
+ * one into memory and walks its records in place.
+ */
+
+#ifndef _solutioncatalog_h
+#define _solutioncatalog_h
+
+#include "genlib.h"
+#include "board.h"
+#include "lexicon.h"
+#include "wordindexset.h"
+#include <vector>
+#include <fstream>
+
+
+/*
+ * Type: catalogCubesT
+ * -------------------
+ * The cubes a cataloged board was shaken from, if they are known.
+ */
+enum catalogCubesT {
+	UnknownCubes,			// the letters were given some other way
+	StandardCubes,			// the 4x4 set
+	BigCubes				// the 5x5 Big Boggle set
+};
+
+
+/*
+ * Function: EncodeSolutionRecord
+ * Usage: EncodeSolutionRecord(board, StandardCubes, words, true, record);
+ * -----------------------------------------------------------------------
+ * This function replaces the contents of record with a catalog record
+ * for the board and its words, given as lexicon indexes in any order,
+ * such as those SolveBoardWords leaves in its seen set. The record holds
+ * the board's size, cubes and letters, and the word indexes in order,
+ * each stored as its difference from the one before in as few bytes as
+ * it needs, 7 bits to a byte. If withPaths is true the record also holds
+ * the first path FindWordPath finds for each word, its length and then
+ * its cells at 5 bits each, packed end to end. Nothing is written to any
+ * file, so workers can encode boards at once and leave the writing to
+ * one thread; reusing record keeps this from allocating. The template
+ * is compiled for StandardBoard and BigBoard in solutioncatalog.cpp.
+ */
+template <typename BoardType>
+  void EncodeSolutionRecord(const BoardType & board, catalogCubesT cubes, const Lexicon & lex,
+							const WordIndexSet & words, bool withPaths, std::vector<unsigned char> & record);
+
+
+/*
+ * Class: SolutionCatalogWriter
+ * ----------------------------
+ * A writer creates a catalog file and appends records to it. The file
+ * starts with a header identifying the lexicon the word indexes belong
+ * to, and the records follow it back to back. Sample use:
+ *
+ *	SolutionCatalogWriter writer("boards.cat", lex);
+ *	EncodeSolutionRecord(board, StandardCubes, lex, words, true, record);
+ *	writer.add(record);
+ *	writer.close();
+ */
+
+class SolutionCatalogWriter {
+
+  public:
+
+   /*
+    * Constructor: SolutionCatalogWriter
+    * Usage: SolutionCatalogWriter writer(filename, lex);
+    * ---------------------------------------------------
+    * The constructor creates the file, replacing any that is there, and
+    * writes its header. It calls Error if the file can't be created.
+    */
+    SolutionCatalogWriter(string filename, const Lexicon & lex);
+
+   /*
+    * Destructor: ~SolutionCatalogWriter
+    * ----------------------------------
+    * The destructor closes the file if close hasn't been called.
+    */
+    ~SolutionCatalogWriter();
+
+   /*
+    * Member function: add
+    * Usage: writer.add(record);
+    * --------------------------
+    * This member function appends a record made by EncodeSolutionRecord.
+    */
+    void add(const std::vector<unsigned char> & record);
+
+   /*
+    * Member function: close
+    * Usage: writer.close();
+    * ----------------------
+    * This member function fills in the number of records in the header
+    * and closes the file, calling Error if anything couldn't be written.
+    */
+    void close();
+
+  private:
+    string filename;
+    ofstream out;
+    int numRecords;
+    bool closed;
+
+    SolutionCatalogWriter(const SolutionCatalogWriter &);		// not to be copied
+    void operator=(const SolutionCatalogWriter &);
+};
+
+
+/*
+ * Class: SolutionCatalog
+ * ----------------------
+ * A catalog maps a file written by SolutionCatalogWriter into memory,
+ * read-only, and reads its records where they lie: opening one takes
+ * the same time however many boards it holds, and stepping through a
+ * record decodes only what is asked for, allocating nothing. Sample use:
+ *
+ *	SolutionCatalog catalog("boards.cat");
+ *	SolutionCatalog::Record record = catalog.firstRecord();
+ *	while (record.isValid()) {
+ *		SolutionCatalog::WordCursor words = record.words();
+ *		while (words.hasNext())
+ *			cout << lex.wordAt(words.next()) << endl;
+ *		record = catalog.nextRecord(record);
+ *	}
+ *
+ * The word indexes are only meaningful with the lexicon the catalog was
+ * written for, which matchesLexicon checks.
+ */
+
+class SolutionCatalog {
+
+  public:
+
+    class Record;
+    class WordCursor;
+
+   /*
+    * Constructor: SolutionCatalog
+    * Usage: SolutionCatalog catalog(filename);
+    * -----------------------------------------
+    * The constructor maps the file and checks its header, calling Error
+    * if it can't be read or wasn't written by a compatible
+    * SolutionCatalogWriter. Each record is checked to fit in the file
+    * as it is reached, and Error is called if one doesn't.
+    */
+    SolutionCatalog(string filename);
+    ~SolutionCatalog();
+
+   /*
+    * Member functions: size, matchesLexicon
+    * Usage: if (catalog.matchesLexicon(lex)) ...
+    * -------------------------------------------
+    * size returns the number of records, and matchesLexicon whether the
+    * lexicon has the same words the writer's did, by their number and a
+    * check of some of them.
+    */
+    int size() const { return numRecords; }
+    bool matchesLexicon(const Lexicon & lex) const;
+
+   /*
+    * Member functions: firstRecord, nextRecord
+    * Usage: record = catalog.nextRecord(record);
+    * -------------------------------------------
+    * These member functions return the first record and the one after a
+    * given record, or a record that isn't valid once there are no more.
+    */
+    Record firstRecord() const;
+    Record nextRecord(const Record & record) const;
+
+  private:
+    unsigned int numRecords;
+    unsigned int numLexiconWords;
+    unsigned int lexiconCheck;
+    const unsigned char *base;		// the mapped file
+    long length;
+    const unsigned char *end;		// just past the last record
+
+    Record recordAt(const unsigned char *data) const;
+    SolutionCatalog(const SolutionCatalog &);		// not to be copied
+    void operator=(const SolutionCatalog &);
+};
+
+
+/*
+ * Class: SolutionCatalog::Record
+ * ------------------------------
+ * A view of one record in a catalog, good as long as the catalog is.
+ */
+
+class SolutionCatalog::Record {
+
+  public:
+
+   /*
+    * Member functions: isValid, numRows, numCols, cubes, letterAt, letters
+    * Usage: string config = record.letters();
+    * ----------------------------------------
+    * isValid returns false for the record after the last. The rest give
+    * the board's size, the cubes it was shaken from, and its letters, one
+    * at a time or all together in the form Board::setLetters accepts.
+    */
+    bool isValid() const { return data != NULL; }
+    int numRows() const { return data[4]; }
+    int numCols() const { return data[5]; }
+    catalogCubesT cubes() const { return (catalogCubesT)data[6]; }
+    char letterAt(int cell) const { return data[HEADER_SIZE + cell]; }
+    string letters() const { return string((const char *)data + HEADER_SIZE, numRows() * numCols()); }
+
+   /*
+    * Member functions: numWords, hasPaths, words
+    * Usage: SolutionCatalog::WordCursor words = record.words();
+    * ----------------------------------------------------------
+    * These member functions give the number of words on the board,
+    * whether the record holds their paths, and a cursor for reading them
+    * in order of their lexicon indexes.
+    */
+    int numWords() const;
+    bool hasPaths() const { return (data[7] & HAS_PATHS) != 0; }
+    WordCursor words() const;
+
+  private:
+    friend class SolutionCatalog;
+    friend class WordCursor;
+    template <typename BoardType>
+      friend void EncodeSolutionRecord(const BoardType &, catalogCubesT, const Lexicon &, const WordIndexSet &, bool,
+									   std::vector<unsigned char> &);
+
+    // The record starts with its size in bytes, rows, columns, cubes,
+    // flags, the number of words and the number of bytes of word
+    // indexes, then the letters, then the word indexes, then the paths,
+    // padded to a multiple of 4 bytes.
+    enum { HEADER_SIZE = 16, HAS_PATHS = 1 };
+
+    const unsigned char *data;		// NULL past the last record
+
+    Record(const unsigned char *data) { this->data = data; }
+    unsigned int size() const;
+    static unsigned int readWord(const unsigned char *bytes);
+};
+
+
+/*
+ * Class: SolutionCatalog::WordCursor
+ * ----------------------------------
+ * Reads the words of a record, and their paths if it has them, one at a
+ * time, straight from the mapped file.
+ */
+
+class SolutionCatalog::WordCursor {
+
+  public:
+
+   /*
+    * Member functions: hasNext, next
+    * Usage: while (words.hasNext()) index = words.next();
+    * ----------------------------------------------------
+    * hasNext returns true if there are words left, and next returns the
+    * lexicon index of the next one, calling Error if there are none.
+    */
+    bool hasNext() const { return wordsLeft > 0; }
+    int next();
+
+   /*
+    * Member functions: pathLength, pathCell
+    * Usage: for (int i = 0; i < words.pathLength(); i++) ... words.pathCell(i) ...
+    * -------------------------------------------------------------------------
+    * If the record has paths, these member functions give the number of
+    * cells in the path of the word next last returned, and each of its
+    * cells; otherwise pathLength returns 0.
+    */
+    int pathLength() const { return length; }
+    int pathCell(int i) const { return path[i]; }
+
+  private:
+    friend class SolutionCatalog::Record;
+
+    const unsigned char *indexes;	// the next word index to decode
+    const unsigned char *paths;		// the start of the packed paths, NULL if there are none
+    long pathBit;					// the next bit of the paths to decode
+    int wordsLeft;
+    int index;
+    int length;
+    int path[MAX_CELLS];
+};
+
+#endif
@@ -0,0 +1,82 @@
+/*
+ * File: solutionindex.cpp
+ * -----------------------
+ * Implements the SolutionIndex class template.
+ */
+
+#include "solutionindex.h"
+#include <cctype>
+
+
+template <typename BoardType>
+  SolutionIndex<BoardType>::SolutionIndex()
+{
+	lex = NULL;
+	numWords = score = 0;
+}
+
+template <typename BoardType>
+  void SolutionIndex<BoardType>::build(const BoardType & board, const Lexicon & lex, ThreadPool & pool)
+{
+	this->lex = &lex;
+	entries.clear();
+	lookup.clear();
+	Set<string> wordsSeen;
+	Vector<string> found;
+	SolveBoardParallel(board, lex, wordsSeen, found, pool);
+	score = 0;
+	for (int i = 0; i < found.size(); i++) {
+		entryT entry;
+		entry.word = found[i];
+		FindWordPath(board, entry.word, entry.path);	// the tracing a search for the word alone would pick
+		lookup.add(entry.word);
+		entries.add(entry);
+		score += ScoreForWord(entry.word);
+	}
+	numWords = found.size();
+}
+
+template <typename BoardType>
+  wordCheckT SolutionIndex<BoardType>::check(const string & word, pathT & path)
+{
+	if (word.length() < MIN_WORD_LENGTH) return WordTooShort;
+	if (word.length() <= BoardType::NUM_CELLS) {		// a longer word can't be on the board
+		char key[BoardType::NUM_CELLS];
+		for (int i = 0; i < word.length(); i++)
+			key[i] = toupper(word[i]);
+		int found = lookup.indexOf(key, word.length());
+		if (found != -1) {
+			entryT & entry = entries[found];
+			path.clear();
+			for (int i = 0; i < word.length(); i++)
+				path.add(entry.path[i]);
+			return WordAccepted;
+		}
+	}
+	if (lex == NULL || !lex->containsWord(word)) return WordNotInLexicon;
+	return WordNotOnBoard;
+}
+
+template <typename BoardType>
+  void SolutionIndex<BoardType>::findRemaining(WordHashSet & wordsSeen, Vector<string> & found)
+{
+	for (int i = 0; i < entries.size(); i++) {
+		if (wordsSeen.add(entries[i].word)) found.add(entries[i].word);
+	}
+}
+
+template <typename BoardType>
+  void SolutionIndex<BoardType>::mapCells(const int cellMap[])
+{
+	for (int i = 0; i < entries.size(); i++) {
+		entryT & entry = entries[i];
+		for (int j = 0; j < entry.word.length(); j++)
+			entry.path[j] = cellMap[entry.path[j]];
+	}
+}
+
+
+// Compiled for the board sizes in board.h (see StandardBoard).
+
+template class SolutionIndex<StandardBoard>;
+template class SolutionIndex<BigBoard>;
@@ -0,0 +1,133 @@
+/*
+ * File: solutionindex.h
+ * ---------------------
+ * Defines the SolutionIndex class template, which holds every word on a
+ * board, solved once, so that checking the words a player enters is a
+ * lookup rather than a search.
+ */
+
+#ifndef _solutionindex_h
+#define _solutionindex_h
+
+#include "genlib.h"
+#include "board.h"
+#include "lexicon.h"
+#include "vector.h"
+#include "wordhashset.h"
+#include "smallvector.h"
+#include "threadpool.h"
+#include "bogglesolver.h"
+
+
+/*
+ * Class: SolutionIndex
+ * --------------------
+ * An index is built from one board, by solving it with SolveBoardParallel,
+ * and keeps each word found, in upper case, in a hash table along with
+ * the first way FindWordPath traces it. Checking a word then costs one
+ * lookup, and the words a player missed are the words in the index they
+ * didn't find, in the order the solver came across them, so the
+ * computer's turn only has to list them. The answers are always the same
+ * as CheckWord's and SolveBoard's for the board. Sample use:
+ *
+ *	SolutionIndex<StandardBoard> solution;
+ *	solution.build(board, lex, pool);
+ *	if (solution.check(word, path) == WordAccepted)...
+ *	solution.findRemaining(wordsSeen, found);
+ *
+ * The index keeps a pointer to the lexicon, which must not change while
+ * the index is in use. The template is compiled for StandardBoard and
+ * BigBoard in solutionindex.cpp.
+ */
+
+template <typename BoardType>
+  class SolutionIndex {
+
+  public:
+
+   /*
+    * Type: pathT
+    * -----------
+    * The cells of a word's path, which always fit without allocating.
+    */
+    typedef SmallVector<int, BoardType::NUM_CELLS> pathT;
+
+   /*
+    * Constructor: SolutionIndex
+    * Usage: SolutionIndex<BigBoard> solution;
+    * ----------------------------------------
+    * The constructor makes an empty index, which holds no words until it
+    * is built.
+    */
+    SolutionIndex();
+
+   /*
+    * Member function: build
+    * Usage: solution.build(board, lex, pool);
+    * ----------------------------------------
+    * This member function solves the board against lex on the threads of
+    * the pool and replaces what the index held with the words found and
+    * their paths.
+    */
+    void build(const BoardType & board, const Lexicon & lex, ThreadPool & pool);
+
+   /*
+    * Member function: check
+    * Usage: if (solution.check(word, path) == WordAccepted)...
+    * ---------------------------------------------------------
+    * This member function checks a word as CheckWord would on the board
+    * the index was built from, without regard to case, and fills in path
+    * with its cells when it is accepted. A word on the board is found
+    * with one lookup, of its letters in upper case in a buffer on the
+    * stack; only a word that isn't goes on to the lexicon, to say why it
+    * was turned down.
+    */
+    wordCheckT check(const string & word, pathT & path);
+
+   /*
+    * Member functions: size, totalScore, wordAt
+    * Usage: for (int i = 0; i < solution.size(); i++)...
+    * ---------------------------------------------------
+    * These member functions return the number of words on the board, the
+    * points they are worth together, and the i-th word, in the order the
+    * solver came across them.
+    */
+    int size() const { return numWords; }
+    int totalScore() const { return score; }
+    string wordAt(int i) { return entries[i].word; }
+
+   /*
+    * Member function: findRemaining
+    * Usage: solution.findRemaining(wordsSeen, found);
+    * ------------------------------------------------
+    * This member function appends to found the words on the board that
+    * aren't in wordsSeen, and adds them to it, just as SolveBoard does,
+    * but without searching the board again.
+    */
+    void findRemaining(WordHashSet & wordsSeen, Vector<string> & found);
+
+   /*
+    * Member function: mapCells
+    * Usage: solution.mapCells(cellMap);
+    * ----------------------------------
+    * This member function renumbers the cells of every path, cell c
+    * becoming cellMap[c], for a caller that reuses an index for a board
+    * with the same cubes rotated or reflected (see SolutionCache).
+    */
+    void mapCells(const int cellMap[]);
+
+  private:
+
+    // A word on the board and its first tracing.
+    struct entryT {
+        string word;
+        int path[BoardType::NUM_CELLS];
+    };
+
+    const Lexicon *lex;
+    Vector<entryT> entries;		// in the order the solver found them
+    WordHashSet lookup;			// the words, in the same order as entries
+    int numWords, score;
+};
+
+#endif
@@ -0,0 +1,158 @@
+/*
+ * File: threadpool.cpp
+ * --------------------
+ * Implements the ThreadPool class on top of POSIX threads.
+ *
+ * Each worker's queue has its own lock, so workers busy with their own
+ * queues don't contend with each other. The pool-wide lock only covers
+ * the counts used to put idle workers to sleep and to tell wait() when
+ * everything is done. A task is pushed onto a queue before numQueued
+ * is raised, so a worker can take it and lower the count first, leaving
+ * it briefly below zero. An idle worker only sleeps after seeing
+ * numQueued at or below zero under the pool lock, and every queued task
+ * the count doesn't include yet still has its raise and signal to come,
+ * so a wakeup can't be lost in between.
+ */
+
+#include "threadpool.h"
+#include <unistd.h>	// for sysconf
+
+
+ThreadPool::ThreadPool(int numThreads)
+{
+	if (numThreads <= 0) numThreads = numProcessors();
+	pthread_mutex_init(&lock, NULL);
+	pthread_cond_init(&workQueued, NULL);
+	pthread_cond_init(&allDone, NULL);
+	numQueued = numUnfinished = nextWorker = 0;
+	shuttingDown = false;
+	for (int i = 0; i < numThreads; i++) {
+		workerT *w = new workerT;
+		w->pool = this;
+		w->index = i;
+		pthread_mutex_init(&w->lock, NULL);
+		workers.push_back(w);
+	}
+	for (int i = 0; i < numThreads; i++) {	// start only once every queue exists, since workers steal from all of them
+		if (pthread_create(&workers[i]->thread, NULL, WorkerMain, workers[i]) != 0)
+			Error("ThreadPool couldn't start a worker thread.");
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	wait();
+	pthread_mutex_lock(&lock);
+	shuttingDown = true;
+	pthread_cond_broadcast(&workQueued);
+	pthread_mutex_unlock(&lock);
+	for (int i = 0; i < workers.size(); i++)
+		pthread_join(workers[i]->thread, NULL);
+	for (int i = 0; i < workers.size(); i++) {
+		pthread_mutex_destroy(&workers[i]->lock);
+		delete workers[i];
+	}
+	pthread_cond_destroy(&allDone);
+	pthread_cond_destroy(&workQueued);
+	pthread_mutex_destroy(&lock);
+}
+
+int ThreadPool::numProcessors()
+{
+	long n = sysconf(_SC_NPROCESSORS_ONLN);
+	return (n > 0) ? (int)n : 1;
+}
+
+// Outside submissions are dealt round-robin; a task submitted from a
+// running task goes on that worker's own queue, which keeps related tasks
+// together until some other worker runs dry and steals them.
+void ThreadPool::submit(taskFnT fn, void *data)
+{
+	taskT task;
+	task.fn = fn;
+	task.data = data;
+	pthread_t self = pthread_self();
+	int target = -1;
+	for (int i = 0; i < workers.size(); i++) {
+		if (pthread_equal(workers[i]->thread, self)) target = i;
+	}
+	pthread_mutex_lock(&lock);
+	if (target == -1) target = nextWorker++ % workers.size();
+	numUnfinished++;
+	pthread_mutex_unlock(&lock);
+
+	workerT *w = workers[target];
+	pthread_mutex_lock(&w->lock);
+	w->tasks.push_back(task);
+	pthread_mutex_unlock(&w->lock);
+
+	pthread_mutex_lock(&lock);
+	numQueued++;
+	pthread_cond_signal(&workQueued);
+	pthread_mutex_unlock(&lock);
+}
+
+void ThreadPool::wait()
+{
+	pthread_mutex_lock(&lock);
+	while (numUnfinished > 0)
+		pthread_cond_wait(&allDone, &lock);
+	pthread_mutex_unlock(&lock);
+}
+
+// Takes the newest task from the worker's own queue, or failing that
+// the oldest task from the first other queue that has one. Returns
+// false if every queue was empty.
+bool ThreadPool::takeTask(int worker, taskT & task)
+{
+	bool found = false;
+	for (int i = 0; i < workers.size() && !found; i++) {
+		workerT *w = workers[(worker + i) % workers.size()];
+		pthread_mutex_lock(&w->lock);
+		if (!w->tasks.empty()) {
+			if (i == 0) {
+				task = w->tasks.back();
+				w->tasks.pop_back();
+			} else {
+				task = w->tasks.front();
+				w->tasks.pop_front();
+			}
+			found = true;
+		}
+		pthread_mutex_unlock(&w->lock);
+	}
+	if (found) {
+		pthread_mutex_lock(&lock);
+		numQueued--;
+		pthread_mutex_unlock(&lock);
+	}
+	return found;
+}
+
+void ThreadPool::finishTask()
+{
+	pthread_mutex_lock(&lock);
+	if (--numUnfinished == 0) pthread_cond_broadcast(&allDone);
+	pthread_mutex_unlock(&lock);
+}
+
+void *ThreadPool::WorkerMain(void *arg)
+{
+	workerT *self = (workerT *)arg;
+	ThreadPool *pool = self->pool;
+	while (true) {
+		taskT task;
+		if (pool->takeTask(self->index, task)) {
+			task.fn(task.data, self->index);
+			pool->finishTask();
+			continue;
+		}
+		pthread_mutex_lock(&pool->lock);
+		while (pool->numQueued <= 0 && !pool->shuttingDown)
+			pthread_cond_wait(&pool->workQueued, &pool->lock);
+		bool done = pool->shuttingDown && pool->numQueued <= 0;
+		pthread_mutex_unlock(&pool->lock);
+		if (done) break;
+	}
+	return NULL;
+}
@@ -0,0 +1,134 @@
+/*
+ * File: threadpool.h
+ * ------------------
+ * Defines the ThreadPool class, a fixed set of worker threads that
+ * share out independent tasks by work stealing.
+ */
+
+#ifndef _threadpool_h
+#define _threadpool_h
+
+#include "genlib.h"
+#include <deque>
+#include <vector>
+#include <pthread.h>
+
+
+/*
+ * Type: taskFnT
+ * -------------
+ * The type of a task function. It is called with the client data given
+ * when the task was submitted and the index (from 0 to numWorkers()-1)
+ * of the worker running it, which a task can use to pick out storage
+ * that belongs to that worker alone.
+ */
+typedef void (*taskFnT)(void *data, int worker);
+
+
+/*
+ * Class: ThreadPool
+ * -----------------
+ * A pool starts its worker threads when it is constructed and stops them
+ * when it is destroyed. Each worker has its own queue of tasks. Submitted
+ * tasks are dealt out to the queues in turn; a worker takes the newest
+ * task from its own queue and, once that is empty, steals the oldest task
+ * from another worker's queue, so the load evens out even when some tasks
+ * take much longer than others. Sample use:
+ *
+ *	ThreadPool pool;
+ *	for (int i = 0; i < numTasks; i++)
+ *		pool.submit(SolveOneTask, &tasks[i]);
+ *	pool.wait();		// all tasks have finished once this returns
+ *
+ * The pool does nothing to protect the clients' data; tasks that run at
+ * the same time must not modify anything they share.
+ */
+
+class ThreadPool {
+
+  public:
+
+   /*
+    * Constructor: ThreadPool
+    * Usage: ThreadPool pool;
+    *        ThreadPool pool(4);
+    * --------------------------
+    * The constructor starts the given number of worker threads, or one per
+    * processor if the number is omitted or not positive.
+    */
+    ThreadPool(int numThreads = 0);
+
+   /*
+    * Destructor: ~ThreadPool
+    * -----------------------
+    * The destructor waits for any submitted tasks to finish and then stops
+    * the worker threads.
+    */
+    ~ThreadPool();
+
+   /*
+    * Member function: numWorkers
+    * Usage: int n = pool.numWorkers();
+    * ---------------------------------
+    * This member function returns the number of worker threads.
+    */
+    int numWorkers() { return workers.size(); }
+
+   /*
+    * Member function: submit
+    * Usage: pool.submit(fn, data);
+    * -----------------------------
+    * This member function queues a call to fn(data, worker) to be run by
+    * one of the workers. It may be called from inside a running task.
+    */
+    void submit(taskFnT fn, void *data);
+
+   /*
+    * Member function: wait
+    * Usage: pool.wait();
+    * -------------------
+    * This member function blocks until every task submitted so far has
+    * finished running.
+    */
+    void wait();
+
+   /*
+    * Static member function: numProcessors
+    * Usage: int n = ThreadPool::numProcessors();
+    * -------------------------------------------
+    * This function returns the number of processors available, or 1 if
+    * that can't be determined.
+    */
+    static int numProcessors();
+
+  private:
+    struct taskT {
+        taskFnT fn;
+        void *data;
+    };
+
+    struct workerT {
+        ThreadPool *pool;
+        int index;
+        pthread_t thread;
+        pthread_mutex_t lock;		// guards tasks
+        std::deque<taskT> tasks;
+    };
+
+    std::vector<workerT *> workers;
+    pthread_mutex_t lock;			// guards the counts and shuttingDown
+    pthread_cond_t workQueued, allDone;
+    int numQueued;					// tasks queued less tasks taken, briefly below zero (see threadpool.cpp)
+    int numUnfinished;				// tasks queued or running
+    int nextWorker;					// queue the next outside submission goes to
+    bool shuttingDown;
+
+    bool takeTask(int worker, taskT & task);
+    void finishTask();
+    static void *WorkerMain(void *arg);
+
+    ThreadPool(const ThreadPool &);			// pools are not copied
+    void operator=(const ThreadPool &);
+};
+
+#endif
@@ -0,0 +1,29 @@
+/*
+ * File: walltime.h
+ * ----------------
+ * Defines CurrentTime, the clock the timers, benchmarks and flashes use.
+ */
+
+#ifndef _walltime_h
+#define _walltime_h
+
+#include <sys/time.h>	// for gettimeofday
+#include <cstddef>		// for NULL
+
+
+/*
+ * Function: CurrentTime
+ * Usage: double start = CurrentTime();
+ * ------------------------------------
+ * This function returns the time in seconds since the epoch, to the
+ * microsecond. It is the clock pthread_cond_timedwait measures its
+ * deadlines against, so a deadline worked out from it can be waited for.
+ */
+inline double CurrentTime()
+{
+	struct timeval now;
+	gettimeofday(&now, NULL);
+	return now.tv_sec + now.tv_usec / 1e6;
+}
+
+#endif
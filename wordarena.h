@@ -0,0 +1,81 @@
+/*
+ * File: wordarena.h
+ * -----------------
+ * Defines the WordArena class, a list of words kept in one buffer.
+ */
+
+#ifndef _wordarena_h
+#define _wordarena_h
+
+#include "genlib.h"
+#include <vector>
+
+
+/*
+ * Class: WordArena
+ * ----------------
+ * A list of words stored back to back in a single character buffer, each
+ * ending in a null character, along with where each one starts. Adding a
+ * word copies its letters to the end of the buffer rather than allocating
+ * a string, and clearing keeps the space, so an arena reused for board
+ * after board stops allocating once it has held the longest list. Sample
+ * use:
+ *
+ *	WordArena words;
+ *	words.add("happy", 5);
+ *	for (int i = 0; i < words.size(); i++)
+ *		cout << words.wordAt(i) << endl;
+ */
+
+class WordArena {
+
+  public:
+
+   /*
+    * Member function: add
+    * Usage: words.add(letters, length);
+    * ----------------------------------
+    * This member function appends the first length characters of letters
+    * to the list as one word.
+    */
+    void add(const char *letters, int length)
+    {
+        starts.push_back(chars.size());
+        chars.insert(chars.end(), letters, letters + length);
+        chars.push_back('\0');
+    }
+
+   /*
+    * Member functions: size, wordAt, lengthAt
+    * Usage: cout << words.wordAt(i);
+    * -------------------------------
+    * These member functions give the number of words in the list, the
+    * i-th word as a null-terminated string, which stays good until the
+    * arena is next added to or cleared, and its length.
+    */
+    int size() const { return starts.size(); }
+    const char *wordAt(int i) const { return &chars[starts[i]]; }
+    int lengthAt(int i) const
+    {
+        int end = (i + 1 < starts.size()) ? starts[i + 1] : chars.size();
+        return end - starts[i] - 1;
+    }
+
+   /*
+    * Member function: clear
+    * Usage: words.clear();
+    * ---------------------
+    * This member function empties the list, keeping its space for reuse.
+    */
+    void clear()
+    {
+        chars.clear();
+        starts.clear();
+    }
+
+  private:
+    std::vector<char> chars;
+    std::vector<int> starts;
+};
+
+#endif
@@ -0,0 +1,173 @@
+/*
+ * File: wordhashset.h
+ * -------------------
+ * Defines the WordHashSet class, a set of words kept in flat arrays.
+ */
+
+#ifndef _wordhashset_h
+#define _wordhashset_h
+
+#include "genlib.h"
+#include <vector>
+#include <cstring>		// for memcmp
+
+
+/*
+ * Class: WordHashSet
+ * ------------------
+ * A set of words, kept as one array of their letters back to back, a
+ * list of the members in the order they were added, and an open-address
+ * hash table of member numbers, probed one slot after another. Unlike
+ * Set<string>, finding a word follows no pointers through a tree and
+ * calls no comparison function: it hashes the letters once and, almost
+ * always, compares them against a single member. A word can be given as
+ * a string or as letters and a length, so a caller that has the letters
+ * in a buffer never builds a string to look them up. Words are compared
+ * exactly, case and all. Sample use:
+ *
+ *	WordHashSet wordsSeen;
+ *	if (wordsSeen.add(word))
+ *		... word wasn't there before ...
+ *	for (int i = 0; i < wordsSeen.size(); i++)
+ *		cout << wordsSeen[i] << endl;
+ */
+
+class WordHashSet {
+
+  public:
+
+    WordHashSet() { slots.resize(MIN_SLOTS); }
+
+   /*
+    * Member function: add
+    * Usage: if (set.add(word))...
+    * ----------------------------
+    * This member function adds a word to the set, returning true if it
+    * was new and false if it was already a member.
+    */
+    bool add(const string & word) { return add(word.data(), word.length()); }
+    bool add(const char *letters, int length)
+    {
+        unsigned int hash = Hash(letters, length);
+        int slot = find(letters, length, hash);
+        if (slots[slot].member != EMPTY) return false;
+        if ((members.size() + 1) * 2 > slots.size()) {		// keep the table at most half full
+            grow();
+            slot = find(letters, length, hash);
+        }
+        memberT member = { (int)text.size(), length };
+        text.insert(text.end(), letters, letters + length);
+        slots[slot].hash = hash;
+        slots[slot].member = members.size();
+        members.push_back(member);
+        return true;
+    }
+
+   /*
+    * Member functions: contains, indexOf
+    * Usage: int i = set.indexOf(letters, length);
+    * --------------------------------------------
+    * contains returns true if the word is in the set, and indexOf gives
+    * its place in the order the members were added, or -1 if it isn't.
+    */
+    bool contains(const string & word) const { return indexOf(word.data(), word.length()) != -1; }
+    bool contains(const char *letters, int length) const { return indexOf(letters, length) != -1; }
+    int indexOf(const string & word) const { return indexOf(word.data(), word.length()); }
+    int indexOf(const char *letters, int length) const
+    {
+        int member = slots[find(letters, length, Hash(letters, length))].member;
+        return (member == EMPTY) ? -1 : member;
+    }
+
+   /*
+    * Member functions: size, operator[]
+    * Usage: string word = set[i];
+    * ----------------------------
+    * These member functions give the number of members and the i-th one
+    * added.
+    */
+    int size() const { return members.size(); }
+    string operator[](int i) const
+    {
+        const memberT & member = members[i];
+        return (member.length == 0) ? string() : string(&text[member.start], member.length);
+    }
+
+   /*
+    * Member function: clear
+    * Usage: set.clear();
+    * -------------------
+    * This member function removes all the members from the set. The
+    * memory it had is kept for the members to come.
+    */
+    void clear()
+    {
+        text.clear();
+        members.clear();
+        slots.assign(slots.size(), slotT());
+    }
+
+  private:
+    enum { EMPTY = -1, MIN_SLOTS = 64 };
+
+    // A member's letters are text[start] to text[start + length - 1].
+    struct memberT {
+        int start;
+        int length;
+    };
+
+    // A slot of the table, with its member's hash so that a probe can
+    // pass most other words without looking at their letters.
+    struct slotT {
+        unsigned int hash;
+        int member;
+        slotT() { hash = 0; member = EMPTY; }
+    };
+
+    std::vector<char> text;
+    std::vector<memberT> members;
+    std::vector<slotT> slots;			// a power of two of them
+
+    static unsigned int Hash(const char *letters, int length)
+    {
+        unsigned int hash = 2166136261u;		// FNV-1a
+        for (int i = 0; i < length; i++) {
+            hash ^= (unsigned char)letters[i];
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    // Returns the slot holding the word, or else the empty slot where
+    // it belongs.
+    int find(const char *letters, int length, unsigned int hash) const
+    {
+        unsigned int mask = slots.size() - 1;
+        for (unsigned int slot = hash & mask; ; slot = (slot + 1) & mask) {
+            const slotT & probe = slots[slot];
+            if (probe.member == EMPTY) return slot;
+            const memberT & member = members[probe.member];
+            if (probe.hash == hash && member.length == length
+                && (length == 0 || memcmp(&text[member.start], letters, length) == 0))
+                return slot;
+        }
+    }
+
+    // Doubles the table and puts every member back in it.
+    void grow()
+    {
+        std::vector<slotT> old;
+        old.swap(slots);
+        slots.resize(old.size() * 2);
+        unsigned int mask = slots.size() - 1;
+        for (int i = 0; i < old.size(); i++) {
+            if (old[i].member == EMPTY) continue;
+            unsigned int slot = old[i].hash & mask;
+            while (slots[slot].member != EMPTY)
+                slot = (slot + 1) & mask;
+            slots[slot] = old[i];
+        }
+    }
+};
+
+#endif
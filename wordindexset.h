@@ -0,0 +1,95 @@
+/*
+ * File: wordindexset.h
+ * --------------------
+ * Defines the WordIndexSet class, a set of lexicon word indexes.
+ */
+
+#ifndef _wordindexset_h
+#define _wordindexset_h
+
+#include "genlib.h"
+#include <vector>
+
+
+/*
+ * Class: WordIndexSet
+ * -------------------
+ * A set of word indexes (see Lexicon::indexOf), kept as one bit per index
+ * along with a list of the members in the order they were added. Adding
+ * and testing are a single bit operation, with no strings and no tree,
+ * and clearing only touches the members, so one set can be reused for
+ * many boards. Sample use:
+ *
+ *	WordIndexSet found;
+ *	if (found.add(lex.indexOf("happy")))
+ *		... "happy" wasn't there before ...
+ *	for (int i = 0; i < found.size(); i++)
+ *		cout << lex.wordAt(found[i]) << endl;
+ */
+
+class WordIndexSet {
+
+  public:
+
+   /*
+    * Member function: add
+    * Usage: if (set.add(index))...
+    * -----------------------------
+    * This member function adds a non-negative index to the set, returning
+    * true if it was new and false if it was already a member.
+    */
+    bool add(int index)
+    {
+        int word = index / BITS_PER_WORD;
+        unsigned long long bit = 1ULL << (index % BITS_PER_WORD);
+        if (word >= bits.size()) bits.resize(word + 1, 0);
+        if (bits[word] & bit) return false;
+        bits[word] |= bit;
+        members.push_back(index);
+        return true;
+    }
+
+   /*
+    * Member function: contains
+    * Usage: if (set.contains(index))...
+    * ----------------------------------
+    * This member function returns true if the index is in the set.
+    */
+    bool contains(int index) const
+    {
+        int word = index / BITS_PER_WORD;
+        return word < bits.size() && ((bits[word] >> (index % BITS_PER_WORD)) & 1);
+    }
+
+   /*
+    * Member functions: size, operator[]
+    * Usage: int index = set[i];
+    * --------------------------
+    * These member functions give the number of members and the i-th one
+    * added.
+    */
+    int size() const { return members.size(); }
+    int operator[](int i) const { return members[i]; }
+
+   /*
+    * Member function: clear
+    * Usage: set.clear();
+    * -------------------
+    * This member function removes all the members from the set, in time
+    * proportional to their number.
+    */
+    void clear()
+    {
+        for (int i = 0; i < members.size(); i++)
+            bits[members[i] / BITS_PER_WORD] = 0;
+        members.clear();
+    }
+
+  private:
+    enum { BITS_PER_WORD = 64 };
+
+    std::vector<unsigned long long> bits;
+    std::vector<int> members;
+};
+
+#endif